@@ -0,0 +1,176 @@
+"""
+Syntax-aware chunking for C++ sources
+
+Splits files on function/class/namespace boundaries so chunks map to code
+entities instead of arbitrary token windows, and attaches file/line metadata
+to each chunk. Uses tree-sitter when the C++ grammar is installed and falls
+back to a brace-depth heuristic otherwise (mirroring the optional-dependency
+pattern used for Neo4j/Milvus in lightrag_wrapper.py).
+"""
+
+import re
+import logging
+from typing import List, Dict, Any
+
+logger = logging.getLogger("code_chunker")
+
+try:
+    import tree_sitter
+    import tree_sitter_cpp
+    _TS_LANGUAGE = tree_sitter.Language(tree_sitter_cpp.language())
+    TREE_SITTER_AVAILABLE = True
+except Exception:
+    TREE_SITTER_AVAILABLE = False
+
+CPP_EXTENSIONS = {".cpp", ".cc", ".cxx", ".c", ".h", ".hpp", ".hh", ".hxx", ".inl"}
+
+# Nodes treated as chunk boundaries when walking a tree-sitter parse
+_TS_UNIT_NODES = {
+    "function_definition",
+    "class_specifier",
+    "struct_specifier",
+    "enum_specifier",
+    "template_declaration",
+}
+
+
+def is_cpp_file(file_path: str) -> bool:
+    """True if the path looks like a C/C++ source or header file"""
+    dot = file_path.rfind(".")
+    return dot >= 0 and file_path[dot:].lower() in CPP_EXTENSIONS
+
+
+def _units_from_tree_sitter(content: str) -> List[tuple]:
+    """Top-level declaration line spans via tree-sitter (0-based, inclusive)"""
+    parser = tree_sitter.Parser(_TS_LANGUAGE)
+    tree = parser.parse(content.encode("utf-8"))
+
+    units = []
+
+    def walk(node):
+        for child in node.children:
+            if child.type == "namespace_definition":
+                # Recurse so each member of a namespace is its own unit
+                walk(child)
+            elif child.type in _TS_UNIT_NODES:
+                units.append((child.start_point[0], child.end_point[0]))
+
+    walk(tree.root_node)
+    return units
+
+
+def _units_from_braces(content: str) -> List[tuple]:
+    """Top-level declaration line spans via brace-depth scanning (fallback)"""
+    lines = content.split("\n")
+    units = []
+    depth = 0
+    unit_start = 0
+    in_block_comment = False
+
+    for line_no, line in enumerate(lines):
+        code = line
+        if in_block_comment:
+            end = code.find("*/")
+            if end < 0:
+                continue
+            code = code[end + 2:]
+            in_block_comment = False
+
+        # Strip comments and string/char literals before counting braces
+        code = re.sub(r'"(?:[^"\\]|\\.)*"', '""', code)
+        code = re.sub(r"'(?:[^'\\]|\\.)*'", "''", code)
+        code = re.sub(r"//.*", "", code)
+        start = code.find("/*")
+        if start >= 0:
+            if "*/" not in code[start:]:
+                in_block_comment = True
+            code = re.sub(r"/\*.*?(\*/|$)", "", code)
+
+        opened = code.count("{")
+        closed = code.count("}")
+        was_top_level = depth == 0
+        depth += opened - closed
+        if depth < 0:
+            depth = 0
+
+        # A brace block returning to depth 0 closes one top-level unit
+        if not was_top_level and depth == 0 and closed > 0:
+            units.append((unit_start, line_no))
+            unit_start = line_no + 1
+
+    if unit_start < len(lines):
+        units.append((unit_start, len(lines) - 1))
+
+    return units
+
+
+def chunk_cpp_source(
+    content: str,
+    file_path: str,
+    max_chunk_chars: int = 6000
+) -> List[Dict[str, Any]]:
+    """
+    Split C++ source into entity-aligned chunks.
+
+    Returns a list of {text, start_line, end_line} dicts (1-based lines);
+    each chunk text is prefixed with a file/line metadata comment so
+    retrieval results carry their provenance.
+    """
+    lines = content.split("\n")
+
+    if TREE_SITTER_AVAILABLE:
+        try:
+            units = _units_from_tree_sitter(content)
+        except Exception as e:
+            logger.warning(f"tree-sitter parse failed for {file_path}, "
+                           f"falling back to brace scan: {e}")
+            units = _units_from_braces(content)
+    else:
+        units = _units_from_braces(content)
+
+    if not units:
+        units = [(0, len(lines) - 1)]
+
+    # Close gaps (preamble, includes, comments between declarations) so no
+    # line is lost, then pack adjacent units up to the size budget
+    covered = []
+    cursor = 0
+    for start, end in units:
+        if start > cursor:
+            covered.append((cursor, start - 1))
+        covered.append((start, end))
+        cursor = end + 1
+    if cursor < len(lines):
+        covered.append((cursor, len(lines) - 1))
+
+    chunks = []
+    chunk_start = None
+    chunk_end = None
+    chunk_size = 0
+
+    def flush():
+        if chunk_start is None:
+            return
+        body = "\n".join(lines[chunk_start:chunk_end + 1])
+        header = f"// File: {file_path} (lines {chunk_start + 1}-{chunk_end + 1})\n"
+        chunks.append({
+            "text": header + body,
+            "start_line": chunk_start + 1,
+            "end_line": chunk_end + 1,
+        })
+
+    for start, end in covered:
+        unit_size = sum(len(lines[i]) + 1 for i in range(start, end + 1))
+
+        if chunk_start is not None and chunk_size + unit_size > max_chunk_chars:
+            flush()
+            chunk_start = None
+            chunk_size = 0
+
+        if chunk_start is None:
+            chunk_start = start
+        chunk_end = end
+        chunk_size += unit_size
+
+    flush()
+    return chunks
@@ -3,23 +3,52 @@ LightRAG Wrapper for MCP Server
 Provides JSON-RPC interface to LightRAG functionality
 """
 
+import io
 import os
+import re
 import sys
 import json
+import time
+import uuid
+import struct
 import asyncio
+import hashlib
 import logging
+import tarfile
 from typing import List, Dict, Any, Optional
 from pathlib import Path
+from collections import OrderedDict
+
+import numpy as np
 
 from lightrag import LightRAG, QueryParam
 from lightrag.llm.openai import openai_complete_if_cache, openai_embed
 from lightrag.kg.shared_storage import initialize_pipeline_status
 from lightrag.utils import setup_logger
 
+from code_chunker import is_cpp_file, chunk_cpp_source
+
 # Setup logging
 setup_logger("lightrag", level="INFO")
 logger = logging.getLogger("lightrag_wrapper")
 
+# Upper bound on persisted query cache entries (oldest evicted first)
+QUERY_CACHE_MAX_ENTRIES = 256
+
+# Per-method latency samples kept for percentile reporting
+METRICS_MAX_SAMPLES = 500
+
+# Version stamp written into exported index bundles; imports refuse
+# bundles with a different format
+BUNDLE_FORMAT_VERSION = 1
+
+
+def _percentile(samples: List[float], fraction: float) -> float:
+    """Nearest-rank percentile of a non-empty sample list"""
+    ordered = sorted(samples)
+    index = min(len(ordered) - 1, int(fraction * len(ordered)))
+    return ordered[index]
+
 
 class LightRAGWrapper:
     """Wrapper for LightRAG with JSON-RPC interface"""
@@ -34,7 +63,16 @@ class LightRAGWrapper:
         milvus_address: Optional[str] = None,
         neo4j_uri: Optional[str] = None,
         neo4j_username: Optional[str] = None,
-        neo4j_password: Optional[str] = None
+        neo4j_password: Optional[str] = None,
+        max_concurrent_requests: int = 8,
+        insert_batch_size: int = 32,
+        file_read_concurrency: int = 16,
+        framing: str = "ndjson",
+        workspaces: Optional[Dict[str, str]] = None,
+        max_warm_workspaces: int = 3,
+        index_bundle: Optional[str] = None,
+        backend_pool_size: int = 8,
+        backend_warmup: bool = True
     ):
         self.working_dir = Path(working_dir)
         self.working_dir.mkdir(parents=True, exist_ok=True)
@@ -49,10 +87,108 @@ class LightRAGWrapper:
         self.neo4j_uri = neo4j_uri
         self.neo4j_username = neo4j_username or "neo4j"
         self.neo4j_password = neo4j_password
-        
+
+        # Backend connection management: driver pool sizing, eager warmup
+        # at initialize, and a health monitor that reconnects with backoff.
+        # Per-backend state: connected, warmup_ms, reconnects, failures
+        self.backend_pool_size = max(1, backend_pool_size)
+        self.backend_warmup = backend_warmup
+        self._backend_health: Dict[str, Dict[str, Any]] = {}
+        self._neo4j_driver = None
+
         self.rag: Optional[LightRAG] = None
         self._initialized = False
-        
+
+        # Prebuilt index bundle restored into an empty working directory on
+        # first initialization (air-gapped sites that can never index)
+        self.index_bundle = index_bundle
+
+        # Concurrency control for the request loop
+        self.max_concurrent_requests = max(1, max_concurrent_requests)
+        self._request_semaphore = asyncio.Semaphore(self.max_concurrent_requests)
+        self._stdout_lock = asyncio.Lock()
+
+        # Ingestion pipeline tuning
+        self.insert_batch_size = max(1, insert_batch_size)
+        self.file_read_concurrency = max(1, file_read_concurrency)
+
+        # Bridge protocol framing, negotiated via LIGHTRAG_FRAMING:
+        # length-prefixed binary frames avoid line scanning over multi-MB
+        # payloads; ndjson remains for direct/manual use
+        self._use_binary_framing = framing == "length-prefixed"
+
+        # Optional out-of-band control channel on fds 3/4 (negotiated via
+        # LIGHTRAG_CONTROL_CHANNEL): ping/status/cancel stay responsive
+        # even when the data pipe is busy with multi-MB frames
+        self._control_writer = None
+        self._control_lock = asyncio.Lock()
+
+        # Multi-workspace routing: requests carrying a workspace name are
+        # served by a warm child wrapper for that workspace's working_dir,
+        # kept in an LRU bounded by max_warm_workspaces so switching repos
+        # costs an LRU hit instead of a cold process start
+        self.workspaces = dict(workspaces or {})
+        self.max_warm_workspaces = max(1, max_warm_workspaces)
+        self._workspace_lru: "OrderedDict[str, LightRAGWrapper]" = OrderedDict()
+
+        # Incremental indexing manifest: path -> {hash, mtime, doc_id}
+        self._manifest_path = self.working_dir / "index_manifest.json"
+        self._manifest = self._load_manifest()
+
+        # Background indexing jobs: job_id -> status record. Job state is
+        # checkpointed to the working directory after every batch so a
+        # wrapper restart can resume a job instead of starting over
+        self._jobs_path = self.working_dir / "index_jobs.json"
+        # File lists live in their own checkpoint, written once per job,
+        # so per-batch progress saves stay small for 40k-file jobs
+        self._job_files_path = self.working_dir / "index_job_files.json"
+        self._jobs: Dict[str, Dict[str, Any]] = self._load_jobs()
+        self._job_tasks: Dict[str, asyncio.Task] = {}
+
+        # Persistent query result cache, invalidated whenever the index
+        # generation is bumped by index_files/insert_text
+        self._query_cache_path = self.working_dir / "query_cache.json"
+        self._query_cache = self._load_query_cache()
+        self._query_cache_mtime = self._file_mtime(self._query_cache_path)
+        self._query_cache_hits = 0
+        self._query_cache_misses = 0
+
+        # Content-addressed embedding cache (chunk hash -> vector), kept as
+        # an append-only JSONL file so duplicated boilerplate is embedded
+        # once per content, ever — including across process restarts
+        self._embedding_cache_path = self.working_dir / "embedding_cache.jsonl"
+        self._embedding_cache = self._load_embedding_cache()
+        self._embedding_cache_hits = 0
+        self._embedding_cache_misses = 0
+
+        # Precomputed community summaries for global-mode queries, refreshed
+        # incrementally at insert time for communities touched by new
+        # entities so queries never pay whole-graph aggregation
+        self._community_path = self.working_dir / "community_summaries.json"
+        self._communities = self._load_communities()
+        self._known_nodes: set = set(self._communities.get("nodes", []))
+        self._community_refresh_running = False
+
+        # Incremental index statistics, updated at insert time and persisted
+        # alongside the manifest so status calls never have to walk the
+        # working directory (it can hold hundreds of thousands of files)
+        self._stats_path = self.working_dir / "index_stats.json"
+        self._stats = self._load_stats()
+        self._stats_mtime = self._file_mtime(self._stats_path)
+
+        # Cached storage snapshot (dir size, graph counts), recomputed only
+        # when the index generation changes — polling status is then free
+        self._status_snapshot: Optional[Dict[str, Any]] = None
+        self._status_snapshot_generation = -1
+
+        # Request metrics: per-method latency samples and backend call counters
+        self._method_samples: Dict[str, List[float]] = {}
+        self._in_flight = 0
+        self._llm_calls = 0
+        self._llm_est_tokens = 0
+        self._embedding_api_calls = 0
+        self._embedding_texts = 0
+
         logger.info(f"LightRAGWrapper initialized with working_dir={working_dir}")
         logger.info(f"Storage: Milvus={milvus_address}, Neo4J={neo4j_uri}")
     
@@ -60,7 +196,21 @@ class LightRAGWrapper:
         """Initialize LightRAG instance if not already initialized"""
         if self._initialized:
             return
-        
+
+        # Restore a shipped bundle before the first real initialization so
+        # air-gapped servers come up query-ready in seconds
+        if self.index_bundle and not self._manifest:
+            try:
+                loop = asyncio.get_event_loop()
+                metadata = await loop.run_in_executor(
+                    None, self._import_bundle_sync, Path(self.index_bundle))
+                self._reload_persisted_state()
+                logger.info(f"Restored index bundle {self.index_bundle} "
+                            f"({metadata.get('manifest_entries', 0)} manifest entries)")
+            except Exception as e:
+                logger.error(f"Could not restore index bundle "
+                             f"{self.index_bundle}: {e}")
+
         logger.info("Initializing LightRAG...")
         
         # Determine storage backends
@@ -74,6 +224,11 @@ class LightRAGWrapper:
                 from lightrag.kg.neo4j_impl import Neo4JStorage
                 logger.info("Using Neo4J for graph storage")
                 storage_kwargs["graph_storage"] = "Neo4JStorage"
+                # The storage impl builds its driver from the environment;
+                # size its connection pool so concurrent sessions reuse
+                # connections instead of churning handshakes
+                os.environ.setdefault(
+                    "NEO4J_MAX_CONNECTION_POOL_SIZE", str(self.backend_pool_size))
             except ImportError:
                 logger.warning("Neo4J libraries not available, falling back to NetworkX")
         
@@ -91,13 +246,13 @@ class LightRAGWrapper:
         # Initialize LightRAG
         self.rag = LightRAG(
             working_dir=str(self.working_dir),
-            llm_model_func=openai_complete_if_cache,
+            llm_model_func=self._tracked_llm_complete,
             llm_model_name=self.openai_model,
             llm_model_kwargs={
                 "api_key": self.openai_api_key,
                 "base_url": self.openai_base_url,
             },
-            embedding_func=openai_embed,
+            embedding_func=self._cached_embed,
             embedding_batch_num=16,
             embedding_func_max_async=16,
             **storage_kwargs
@@ -105,45 +260,884 @@ class LightRAGWrapper:
         
         self._initialized = True
         logger.info("LightRAG initialized successfully")
-    
-    async def index_files(self, file_paths: List[str]) -> Dict[str, Any]:
-        """Index code files"""
+
+        # Establish backend connections now so the first real request does
+        # not pay connection setup (TLS handshake, auth, pool fill)
+        if self.backend_warmup:
+            await self._warmup_backends()
+
+    async def _warmup_backends(self):
+        """Eagerly connect to configured storage backends"""
+        if self.neo4j_uri and self.neo4j_password:
+            await self._connect_backend("neo4j", self._connect_neo4j)
+        if self.milvus_address:
+            await self._connect_backend("milvus", self._connect_milvus)
+
+    async def _connect_backend(self, name: str, connect):
+        """Run one backend's connect routine, tracking health and timing"""
+        health = self._backend_health.setdefault(name, {
+            "connected": False,
+            "pool_size": self.backend_pool_size,
+            "warmup_ms": None,
+            "reconnects": 0,
+            "consecutive_failures": 0,
+            "last_error": None,
+        })
+
+        was_connected = health["connected"]
+        start = time.monotonic()
+        try:
+            await connect()
+            health["warmup_ms"] = round((time.monotonic() - start) * 1000, 1)
+            health["connected"] = True
+            health["consecutive_failures"] = 0
+            health["last_error"] = None
+            if not was_connected:
+                logger.info(f"Backend '{name}' connected in {health['warmup_ms']}ms "
+                            f"(pool_size={self.backend_pool_size})")
+        except ImportError:
+            # Driver not installed; LightRAG already fell back, nothing to warm
+            self._backend_health.pop(name, None)
+        except Exception as e:
+            health["connected"] = False
+            health["consecutive_failures"] += 1
+            health["last_error"] = str(e)
+            logger.error(f"Backend '{name}' connection failed: {e}")
+
+    async def _connect_neo4j(self):
+        """Open (or verify) the pooled Neo4j driver"""
+        from neo4j import AsyncGraphDatabase
+
+        if self._neo4j_driver is None:
+            self._neo4j_driver = AsyncGraphDatabase.driver(
+                self.neo4j_uri,
+                auth=(self.neo4j_username, self.neo4j_password),
+                max_connection_pool_size=self.backend_pool_size,
+            )
+        await self._neo4j_driver.verify_connectivity()
+
+    async def _connect_milvus(self):
+        """Open (or verify) the Milvus connection"""
+        from pymilvus import connections
+
+        loop = asyncio.get_event_loop()
+        await loop.run_in_executor(
+            None,
+            lambda: connections.connect(alias="lightrag_warmup", uri=self.milvus_address),
+        )
+
+    async def _monitor_backends(self):
+        """Periodically verify backend connectivity; reconnect with backoff.
+
+        A healthy backend is re-checked every 60 s. After a failure the
+        retry interval starts at 1 s and doubles up to 30 s, so a restarted
+        Neo4j/Milvus server is picked up within seconds instead of waiting
+        for the next request to fail.
+        """
+        check_interval = 60.0
+        backoff = 1.0
+
+        while True:
+            degraded = any(
+                not health["connected"] for health in self._backend_health.values()
+            )
+            await asyncio.sleep(backoff if degraded else check_interval)
+
+            if not self._initialized or not self._backend_health:
+                continue
+
+            for name in list(self._backend_health):
+                was_connected = self._backend_health[name]["connected"]
+                connect = self._connect_neo4j if name == "neo4j" else self._connect_milvus
+                await self._connect_backend(name, connect)
+                if not was_connected and self._backend_health[name]["connected"]:
+                    self._backend_health[name]["reconnects"] += 1
+                    logger.info(f"Backend '{name}' reconnected")
+
+            if any(not h["connected"] for h in self._backend_health.values()):
+                backoff = min(backoff * 2, 30.0)
+            else:
+                backoff = 1.0
+
+    def _load_manifest(self) -> Dict[str, Any]:
+        """Load the incremental indexing manifest from the working directory"""
+        try:
+            if self._manifest_path.exists():
+                with open(self._manifest_path, 'r', encoding='utf-8') as f:
+                    return json.load(f)
+        except Exception as e:
+            logger.warning(f"Could not load index manifest, starting fresh: {e}")
+        return {}
+
+    def _save_manifest(self):
+        """Persist the indexing manifest atomically"""
+        try:
+            tmp_path = self._manifest_path.with_suffix('.json.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                json.dump(self._manifest, f)
+            tmp_path.replace(self._manifest_path)
+        except Exception as e:
+            logger.error(f"Could not save index manifest: {e}")
+
+    def _load_communities(self) -> Dict[str, Any]:
+        """Load persisted community summaries (keyed by membership hash)"""
+        try:
+            if self._community_path.exists():
+                with open(self._community_path, 'r', encoding='utf-8') as f:
+                    data = json.load(f)
+                if "communities" in data:
+                    return data
+        except Exception as e:
+            logger.warning(f"Could not load community summaries, starting fresh: {e}")
+        return {"communities": {}, "nodes": []}
+
+    def _save_communities(self):
+        """Persist community summaries atomically"""
+        try:
+            tmp_path = self._community_path.with_suffix('.json.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                json.dump(self._communities, f)
+            tmp_path.replace(self._community_path)
+        except Exception as e:
+            logger.error(f"Could not save community summaries: {e}")
+
+    async def _update_community_summaries(self):
+        """Refresh community summaries without stalling the event loop.
+
+        Label propagation walks the whole graph, so on a large index a
+        refresh takes long enough to starve concurrent pings and searches
+        if run inline. It is offloaded to the default executor, and while
+        one refresh is in flight further requests are dropped — the next
+        insert triggers a fresh pass over the then-current graph.
+        """
+        if self._community_refresh_running:
+            logger.debug("Community refresh already in flight, skipping")
+            return
+        self._community_refresh_running = True
+        try:
+            loop = asyncio.get_event_loop()
+            await loop.run_in_executor(None, self._update_community_summaries_sync)
+        finally:
+            self._community_refresh_running = False
+
+    def _update_community_summaries_sync(self):
+        """Detect communities and re-summarize the ones whose membership changed.
+
+        Detection with label propagation is near-linear in graph size and runs
+        on every refresh; each community is keyed by a hash of its membership,
+        so only communities actually touched by the insert pay for a new
+        summary — the rest keep their stored one.
+        """
+        try:
+            import networkx as nx
+        except ImportError:
+            return
+
+        try:
+            graph = getattr(self.rag.chunk_entity_relation_graph, "_graph", None)
+            if graph is None or graph.number_of_nodes() == 0:
+                return
+
+            current_nodes = set(graph.nodes)
+            touched = current_nodes - self._known_nodes
+            if not touched and self._communities["communities"]:
+                return
+
+            updated = 0
+            kept: Dict[str, Any] = {}
+            for members in nx.algorithms.community.label_propagation_communities(graph):
+                members = set(members)
+                key = hashlib.md5(
+                    "\n".join(sorted(members)).encode('utf-8')
+                ).hexdigest()[:12]
+
+                existing = self._communities["communities"].get(key)
+                if existing is not None:
+                    kept[key] = existing
+                    continue
+
+                kept[key] = self._summarize_community(graph, members)
+                updated += 1
+
+            self._communities = {"communities": kept, "nodes": sorted(current_nodes)}
+            self._known_nodes = current_nodes
+            self._save_communities()
+            logger.info(f"Community summaries refreshed: {updated} updated, "
+                        f"{len(kept)} total")
+        except Exception as e:
+            logger.warning(f"Could not update community summaries: {e}")
+
+    @staticmethod
+    def _summarize_community(graph, members: set) -> Dict[str, Any]:
+        """Structural summary of one community: hub entities, types, themes"""
+        ranked = sorted(members, key=lambda n: graph.degree(n), reverse=True)
+        top = ranked[:10]
+
+        lines = []
+        for name in top:
+            data = graph.nodes.get(name) or {}
+            entity_type = (data.get("entity_type") or "unknown").strip('"')
+            description = (data.get("description") or "").split("<SEP>")[0].strip()
+            if description:
+                lines.append(f"- {name} ({entity_type}): {description[:200]}")
+            else:
+                lines.append(f"- {name} ({entity_type})")
+
+        keywords: Dict[str, int] = {}
+        for _, _, data in graph.edges(top, data=True):
+            for keyword in (data.get("keywords") or "").split(","):
+                keyword = keyword.strip()
+                if keyword:
+                    keywords[keyword] = keywords.get(keyword, 0) + 1
+        top_keywords = sorted(keywords, key=lambda k: keywords[k], reverse=True)[:10]
+
+        summary = (f"Module around {', '.join(top[:3])} "
+                   f"({len(members)} entities). Key members:\n" + "\n".join(lines))
+        if top_keywords:
+            summary += f"\nThemes: {', '.join(top_keywords)}"
+
+        return {
+            "size": len(members),
+            "top_entities": top,
+            "keywords": top_keywords,
+            "summary": summary,
+        }
+
+    # Function words carry no signal about which module a query is about;
+    # they must not count as overlap when ranking community summaries
+    _STOPWORDS = frozenset(
+        "the and for how what why who which are was were does did has have "
+        "had can could would should this that these those with from into "
+        "about between where when whose them they there here not all any "
+        "each other than then its his her our your their been being is it "
+        "of in on to by as at or an a do be we you i".split())
+
+    @classmethod
+    def _content_terms(cls, text: str) -> set:
+        """Lowercased content tokens, split on underscores and non-word runs"""
+        return {t for t in re.split(r"[^a-z0-9]+", text.lower())
+                if len(t) > 2 and t not in cls._STOPWORDS}
+
+    def _rank_communities(self, query: str) -> List[Dict[str, Any]]:
+        """Rank community summaries by lexical overlap with the query"""
+        terms = self._content_terms(query)
+
+        scored = []
+        for community in self._communities["communities"].values():
+            haystack = self._content_terms(
+                " ".join(community["top_entities"] + community["keywords"]))
+            score = len(terms & haystack)
+            # One shared token is noise; require at least two content terms
+            # in common before a summary may stand in for the native global
+            # pipeline. Queries matching nothing fall through to rag.aquery
+            if score > 1:
+                scored.append((score, community))
+
+        scored.sort(key=lambda pair: (pair[0], pair[1]["size"]), reverse=True)
+        return [community for _, community in scored]
+
+    async def _answer_from_communities(
+        self, query: str, response_type: str, max_communities: int = 8
+    ) -> Optional[str]:
+        """Answer a global-mode query from precomputed community summaries"""
+        ranked = self._rank_communities(query)[:max_communities]
+        if not ranked:
+            return None
+
+        context = "\n\n".join(c["summary"] for c in ranked)
+        system_prompt = (
+            "You are a codebase architecture assistant. Answer the question "
+            "using only the precomputed module summaries below. Each summary "
+            "lists a module's hub entities and themes."
+        )
+        prompt = (f"Module summaries:\n\n{context}\n\n"
+                  f"Question: {query}\n\n"
+                  f"Respond as: {response_type}")
+
+        return await self._tracked_llm_complete(
+            self.openai_model,
+            prompt,
+            system_prompt=system_prompt,
+            api_key=self.openai_api_key,
+            base_url=self.openai_base_url,
+        )
+
+    def _load_jobs(self) -> Dict[str, Dict[str, Any]]:
+        """Load checkpointed job records; jobs cut off mid-run become resumable"""
+        jobs: Dict[str, Dict[str, Any]] = {}
+        try:
+            if self._jobs_path.exists():
+                with open(self._jobs_path, 'r', encoding='utf-8') as f:
+                    jobs = json.load(f)
+                for job in jobs.values():
+                    job["cancel_requested"] = False
+                    if job.get("status") == "running":
+                        # The previous process died mid-job; completed batches
+                        # are durable in the manifest, the rest can be resumed
+                        job["status"] = "interrupted"
+                if jobs:
+                    logger.info(f"Loaded {len(jobs)} checkpointed index jobs")
+
+            # File lists are checkpointed separately (written once per job)
+            if jobs and self._job_files_path.exists():
+                with open(self._job_files_path, 'r', encoding='utf-8') as f:
+                    job_files = json.load(f)
+                for job_id, job in jobs.items():
+                    job["file_paths"] = job_files.get(job_id, [])
+        except Exception as e:
+            logger.warning(f"Could not load index jobs, starting fresh: {e}")
+        return jobs
+
+    def _save_jobs(self):
+        """Checkpoint job progress atomically.
+
+        File lists are excluded here -- they are immutable per job and
+        saved once by _save_job_files, so the per-batch progress writes
+        stay a few hundred bytes per job instead of multiple MB.
+        """
+        try:
+            serializable = {
+                job_id: {k: v for k, v in job.items()
+                         if k not in ("cancel_requested", "file_paths")}
+                for job_id, job in self._jobs.items()
+            }
+            tmp_path = self._jobs_path.with_suffix('.json.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                json.dump(serializable, f)
+            tmp_path.replace(self._jobs_path)
+        except Exception as e:
+            logger.error(f"Could not save index jobs: {e}")
+
+    def _save_job_files(self):
+        """Checkpoint each job's file list (called when a job is created)"""
+        try:
+            job_files = {job_id: job.get("file_paths", [])
+                         for job_id, job in self._jobs.items()}
+            tmp_path = self._job_files_path.with_suffix('.json.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                json.dump(job_files, f)
+            tmp_path.replace(self._job_files_path)
+        except Exception as e:
+            logger.error(f"Could not save index job file lists: {e}")
+
+    def _load_stats(self) -> Dict[str, Any]:
+        """Load the running index statistics counters"""
+        try:
+            if self._stats_path.exists():
+                with open(self._stats_path, 'r', encoding='utf-8') as f:
+                    stats = json.load(f)
+                # The counter previously named "chunks" actually counted
+                # inserted documents, not LightRAG text chunks
+                if "inserted_docs" not in stats:
+                    stats["inserted_docs"] = stats.pop("chunks", 0)
+                return stats
+        except Exception as e:
+            logger.warning(f"Could not load index stats, starting fresh: {e}")
+        return {"documents": 0, "inserted_docs": 0, "content_bytes": 0}
+
+    def _save_stats(self):
+        """Persist the index statistics atomically"""
+        try:
+            tmp_path = self._stats_path.with_suffix('.json.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                json.dump(self._stats, f)
+            tmp_path.replace(self._stats_path)
+            self._stats_mtime = self._file_mtime(self._stats_path)
+        except Exception as e:
+            logger.error(f"Could not save index stats: {e}")
+
+    def _load_query_cache(self) -> Dict[str, Any]:
+        """Load the persisted query cache (generation counter + entries)"""
+        try:
+            if self._query_cache_path.exists():
+                with open(self._query_cache_path, 'r', encoding='utf-8') as f:
+                    cache = json.load(f)
+                if "generation" in cache and "entries" in cache:
+                    return cache
+        except Exception as e:
+            logger.warning(f"Could not load query cache, starting fresh: {e}")
+        return {"generation": 0, "entries": {}}
+
+    def _save_query_cache(self):
+        """Persist the query cache atomically"""
+        try:
+            tmp_path = self._query_cache_path.with_suffix('.json.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                json.dump(self._query_cache, f)
+            tmp_path.replace(self._query_cache_path)
+            self._query_cache_mtime = self._file_mtime(self._query_cache_path)
+        except Exception as e:
+            logger.error(f"Could not save query cache: {e}")
+
+    @staticmethod
+    def _file_mtime(path: Path) -> Optional[float]:
+        """mtime of a state file, or None if it does not exist yet"""
+        try:
+            return path.stat().st_mtime
+        except OSError:
+            return None
+
+    def _refresh_query_cache(self):
+        """Pick up generation bumps written by sibling pool processes.
+
+        With pool_size > 1 the write worker bumps the generation in
+        query_cache.json while read workers only hold an in-memory copy;
+        a cheap mtime check before trusting (or saving) cached entries
+        keeps every process on the current generation.
+        """
+        mtime = self._file_mtime(self._query_cache_path)
+        if mtime == self._query_cache_mtime:
+            return
+        self._query_cache_mtime = mtime
+
+        on_disk = self._load_query_cache()
+        if on_disk["generation"] != self._query_cache["generation"]:
+            logger.debug(
+                f"Adopting index generation {on_disk['generation']} "
+                f"from disk (was {self._query_cache['generation']})")
+            self._query_cache = on_disk
+
+    def _refresh_stats(self):
+        """Reload index stats if a sibling pool process updated them"""
+        mtime = self._file_mtime(self._stats_path)
+        if mtime == self._stats_mtime:
+            return
+        self._stats_mtime = mtime
+        self._stats = self._load_stats()
+
+    def _bump_index_generation(self):
+        """Invalidate all cached query results after an index mutation"""
+        self._query_cache["generation"] += 1
+        self._query_cache["entries"] = {}
+        self._save_query_cache()
+        logger.debug(f"Index generation bumped to {self._query_cache['generation']}")
+
+    def _load_embedding_cache(self) -> Dict[str, List[float]]:
+        """Load the append-only embedding cache (last write wins per hash).
+
+        Entries are stamped with the embedding model that produced them;
+        vectors from a different model (or unstamped legacy entries) are
+        discarded so a model switch can never feed wrong-dimension vectors
+        into the store, and the file is rewritten without them.
+        """
+        cache: Dict[str, List[float]] = {}
+        dropped = 0
+        try:
+            if self._embedding_cache_path.exists():
+                with open(self._embedding_cache_path, 'r', encoding='utf-8') as f:
+                    for line in f:
+                        line = line.strip()
+                        if not line:
+                            continue
+                        entry = json.loads(line)
+                        if entry.get("model") != self.openai_embedding_model:
+                            dropped += 1
+                            continue
+                        cache[entry["hash"]] = entry["vector"]
+                if dropped:
+                    logger.info(
+                        f"Discarding {dropped} cached embeddings from a "
+                        f"different model (using {self.openai_embedding_model})")
+                    self._rewrite_embedding_cache(cache)
+                logger.info(f"Loaded {len(cache)} cached embeddings")
+        except Exception as e:
+            logger.warning(f"Could not load embedding cache, starting fresh: {e}")
+        return cache
+
+    def _rewrite_embedding_cache(self, cache: Dict[str, List[float]]):
+        """Compact the cache file to the surviving entries atomically"""
+        try:
+            tmp_path = self._embedding_cache_path.with_suffix('.jsonl.tmp')
+            with open(tmp_path, 'w', encoding='utf-8') as f:
+                for content_hash, vector in cache.items():
+                    f.write(json.dumps({
+                        "hash": content_hash,
+                        "model": self.openai_embedding_model,
+                        "vector": vector,
+                    }) + "\n")
+            tmp_path.replace(self._embedding_cache_path)
+        except Exception as e:
+            logger.error(f"Could not rewrite embedding cache: {e}")
+
+    def _append_embedding_cache(self, new_entries: Dict[str, List[float]]):
+        """Append newly computed vectors to the cache file"""
+        try:
+            with open(self._embedding_cache_path, 'a', encoding='utf-8') as f:
+                for content_hash, vector in new_entries.items():
+                    f.write(json.dumps({
+                        "hash": content_hash,
+                        "model": self.openai_embedding_model,
+                        "vector": vector,
+                    }) + "\n")
+        except Exception as e:
+            logger.error(f"Could not append to embedding cache: {e}")
+
+    async def _cached_embed(self, texts: List[str], **kwargs) -> np.ndarray:
+        """Embedding function with a content-addressed cache in front of the API"""
+        results: List[Optional[List[float]]] = [None] * len(texts)
+        missing_texts = []
+        missing_indices = []
+
+        for i, text in enumerate(texts):
+            content_hash = self._content_hash(text)
+            cached = self._embedding_cache.get(content_hash)
+            if cached is not None:
+                results[i] = cached
+                self._embedding_cache_hits += 1
+            else:
+                missing_texts.append(text)
+                missing_indices.append(i)
+                self._embedding_cache_misses += 1
+
+        if missing_texts:
+            self._embedding_api_calls += 1
+            self._embedding_texts += len(missing_texts)
+            vectors = await openai_embed(missing_texts, **kwargs)
+            new_entries = {}
+            for i, vector in zip(missing_indices, vectors):
+                as_list = [float(v) for v in vector]
+                results[i] = as_list
+                new_entries[self._content_hash(texts[i])] = as_list
+
+            self._embedding_cache.update(new_entries)
+            self._append_embedding_cache(new_entries)
+
+        return np.array(results, dtype=np.float32)
+
+    @staticmethod
+    def _query_cache_key(query: str, query_params: Dict[str, Any]) -> str:
+        """Cache key over the normalized query and retrieval parameters"""
+        normalized = " ".join(query.split())
+        raw = json.dumps([normalized, query_params], sort_keys=True)
+        return hashlib.sha256(raw.encode('utf-8')).hexdigest()
+
+    @staticmethod
+    def _content_hash(content: str) -> str:
+        """Content hash used for change detection in the manifest"""
+        return hashlib.sha256(content.encode('utf-8')).hexdigest()
+
+    def _read_file_sync(self, file_path: str) -> tuple:
+        """Read a single file; returns (path, content, mtime, error)"""
+        try:
+            path = Path(file_path)
+            if not path.exists():
+                return (file_path, None, None, f"File not found: {file_path}")
+
+            mtime = path.stat().st_mtime
+            with open(path, 'r', encoding='utf-8') as f:
+                return (file_path, f.read(), mtime, None)
+
+        except Exception as e:
+            return (file_path, None, None, f"Error reading {file_path}: {str(e)}")
+
+    async def index_files(
+        self,
+        file_paths: List[str],
+        _job: Optional[Dict[str, Any]] = None
+    ) -> Dict[str, Any]:
+        """Index code files through a parallel read + batched insert pipeline"""
         await self.initialize()
-        
-        logger.info(f"Indexing {len(file_paths)} files...")
-        
+
+        logger.info(f"Indexing {len(file_paths)} files "
+                    f"(batch_size={self.insert_batch_size})...")
+
         success_count = 0
+        skipped_count = 0
+        new_count = 0
+        updated_count = 0
+        failed_count = 0  # files, not error messages: a failed batch is N files
         errors = []
-        
-        for file_path in file_paths:
+
+        loop = asyncio.get_event_loop()
+        read_semaphore = asyncio.Semaphore(self.file_read_concurrency)
+
+        async def read_one(file_path: str) -> tuple:
+            async with read_semaphore:
+                return await loop.run_in_executor(None, self._read_file_sync, file_path)
+
+        async def read_batches():
+            """Yield insert-sized batches of changed files as they are read.
+
+            Only one batch (plus the prefetched next one) is ever resident,
+            so a 40k-file tree does not pull gigabytes into memory before
+            the first insert.
+            """
+            nonlocal skipped_count, new_count, updated_count, failed_count
+            batch_contents: List[str] = []
+            batch_paths: List[str] = []
+            batch_entries: List[Dict[str, Any]] = []
+
+            for start in range(0, len(file_paths), self.file_read_concurrency):
+                window = file_paths[start:start + self.file_read_concurrency]
+                read_results = await asyncio.gather(*(read_one(fp) for fp in window))
+
+                for file_path, content, mtime, error in read_results:
+                    if error:
+                        logger.error(error)
+                        errors.append(error)
+                        failed_count += 1
+                        continue
+
+                    # Skip files whose content is unchanged since the last
+                    # index run
+                    content_hash = self._content_hash(content)
+                    previous = self._manifest.get(file_path)
+                    if previous and previous.get("hash") == content_hash:
+                        skipped_count += 1
+                        logger.debug(f"Unchanged, skipping: {file_path}")
+                        continue
+
+                    if previous:
+                        updated_count += 1
+                    else:
+                        new_count += 1
+
+                    batch_contents.append(content)
+                    batch_paths.append(file_path)
+                    batch_entries.append({
+                        "hash": content_hash,
+                        "mtime": mtime,
+                        "doc_id": "doc-" + hashlib.md5(
+                            content.encode('utf-8')).hexdigest(),
+                    })
+
+                    if len(batch_contents) >= self.insert_batch_size:
+                        yield batch_contents, batch_paths, batch_entries
+                        batch_contents, batch_paths, batch_entries = [], [], []
+
+            if batch_contents:
+                yield batch_contents, batch_paths, batch_entries
+
+        async def next_batch(gen):
             try:
-                path = Path(file_path)
-                if not path.exists():
-                    errors.append(f"File not found: {file_path}")
-                    continue
-                
-                with open(path, 'r', encoding='utf-8') as f:
-                    content = f.read()
-                
-                await self.rag.ainsert(content)
-                success_count += 1
-                logger.debug(f"Indexed: {file_path}")
-                
+                return await gen.__anext__()
+            except StopAsyncIteration:
+                return None
+
+        # Insert in batches so LightRAG's pipeline can overlap embedding and
+        # extraction across documents (embedding_func_max_async is already
+        # configured); the next batch is read while the current one inserts
+        batches = read_batches()
+        prefetch = asyncio.create_task(next_batch(batches))
+        while True:
+            batch = await prefetch
+            if batch is None:
+                break
+            prefetch = asyncio.create_task(next_batch(batches))
+
+            if _job and _job.get("cancel_requested"):
+                prefetch.cancel()
+                logger.info(f"Job {_job['job_id']} cancelled after "
+                            f"{success_count} files")
+                break
+
+            batch_contents, batch_paths, batch_entries = batch
+
+            # Expand C++ files into entity-aligned chunks so LightRAG's
+            # generic token-window chunker never splits a class or function
+            # mid-body; other file types go in whole
+            batch_docs = []
+            batch_doc_paths = []
+            for file_path, content in zip(batch_paths, batch_contents):
+                if is_cpp_file(file_path):
+                    for chunk in chunk_cpp_source(content, file_path):
+                        batch_docs.append(chunk["text"])
+                        batch_doc_paths.append(file_path)
+                else:
+                    batch_docs.append(content)
+                    batch_doc_paths.append(file_path)
+
+            try:
+                await self.rag.ainsert(batch_docs, file_paths=batch_doc_paths)
+                success_count += len(batch_contents)
+                logger.debug(f"Indexed batch of {len(batch_contents)} files "
+                             f"({success_count + skipped_count}/{len(file_paths)})")
+
+                # Record successful batch in the manifest so a rerun skips it
+                for file_path, entry in zip(batch_paths, batch_entries):
+                    self._manifest[file_path] = entry
+                self._save_manifest()
+
+                # Keep running statistics current at insert time
+                self._stats["documents"] += len(batch_contents)
+                self._stats["inserted_docs"] += len(batch_docs)
+                self._stats["content_bytes"] += sum(len(c) for c in batch_contents)
+                self._save_stats()
+
             except Exception as e:
-                error_msg = f"Error indexing {file_path}: {str(e)}"
+                error_msg = f"Error indexing batch starting at {batch_paths[0]}: {str(e)}"
                 logger.error(error_msg)
                 errors.append(error_msg)
-        
+                failed_count += len(batch_contents)
+
+            if _job:
+                _job.update({
+                    "processed": skipped_count + success_count + failed_count,
+                    "success_count": success_count,
+                    "skipped_count": skipped_count,
+                    "error_count": failed_count,
+                })
+                self._save_jobs()
+                await self._notify("index_progress", {
+                    "job_id": _job["job_id"],
+                    "processed": _job["processed"],
+                    "total": _job["total"],
+                    "success_count": success_count,
+                    "skipped_count": skipped_count,
+                    "error_count": failed_count,
+                })
+
+        if _job:
+            # A fully-skipped run yields no batches, so the per-batch
+            # checkpoint above never fires; record the final counts here
+            _job.update({
+                "processed": skipped_count + success_count + failed_count,
+                "success_count": success_count,
+                "skipped_count": skipped_count,
+                "error_count": failed_count,
+            })
+
+        if success_count > 0:
+            await self._update_community_summaries()
+            self._bump_index_generation()
+
         result = {
             "success_count": success_count,
-            "error_count": len(errors),
+            "skipped_count": skipped_count,
+            "new_count": new_count,
+            "updated_count": updated_count,
+            "error_count": failed_count,
             "errors": errors,
             "total": len(file_paths)
         }
-        
-        logger.info(f"Indexing complete: {success_count}/{len(file_paths)} successful")
+
+        logger.info(f"Indexing complete: {success_count} indexed, "
+                    f"{skipped_count} unchanged, {failed_count} failed "
+                    f"({len(file_paths)} total)")
         return result
     
+    async def start_index_job(self, file_paths: List[str]) -> Dict[str, Any]:
+        """Start indexing in the background; returns a job id immediately"""
+        job_id = uuid.uuid4().hex[:12]
+        job = {
+            "job_id": job_id,
+            "status": "running",
+            "total": len(file_paths),
+            "processed": 0,
+            "success_count": 0,
+            "skipped_count": 0,
+            "error_count": 0,
+            "errors": [],
+            "cancel_requested": False,
+            "started_at": time.time(),
+            "finished_at": None,
+            # Kept in the checkpoint so the job can be resumed after a restart
+            "file_paths": file_paths,
+        }
+        self._jobs[job_id] = job
+        self._save_jobs()
+        self._save_job_files()
+
+        task = asyncio.create_task(self._run_index_job(job_id, file_paths))
+        self._job_tasks[job_id] = task
+        task.add_done_callback(lambda _: self._job_tasks.pop(job_id, None))
+
+        logger.info(f"Started index job {job_id} for {len(file_paths)} files")
+        return {"job_id": job_id, "total": len(file_paths), "status": "running"}
+
+    async def _run_index_job(self, job_id: str, file_paths: List[str]):
+        """Drive a background indexing job and record its outcome"""
+        job = self._jobs[job_id]
+        try:
+            result = await self.index_files(file_paths, _job=job)
+            job["errors"] = result["errors"]
+            job["status"] = "cancelled" if job.get("cancel_requested") else "completed"
+        except Exception as e:
+            logger.error(f"Index job {job_id} failed: {e}", exc_info=True)
+            job["status"] = "failed"
+            job["errors"].append(str(e))
+        finally:
+            job["finished_at"] = time.time()
+            self._save_jobs()
+            await self._notify("index_progress", {
+                "job_id": job_id,
+                "processed": job["processed"],
+                "total": job["total"],
+                "status": job["status"],
+            })
+
+    async def get_job_status(self, job_id: str) -> Dict[str, Any]:
+        """Get status/progress of a background indexing job"""
+        job = self._jobs.get(job_id)
+        if job is None:
+            raise ValueError(f"Unknown job: {job_id}")
+
+        status = {k: v for k, v in job.items()
+                  if k not in ("cancel_requested", "file_paths")}
+        elapsed = (job["finished_at"] or time.time()) - job["started_at"]
+        status["elapsed_seconds"] = round(elapsed, 2)
+
+        # Simple rate-based ETA while the job is still running
+        if job["status"] == "running" and job["processed"] > 0:
+            rate = job["processed"] / max(elapsed, 0.001)
+            status["eta_seconds"] = round((job["total"] - job["processed"]) / rate, 2)
+
+        return status
+
+    async def resume_index_job(self, job_id: str) -> Dict[str, Any]:
+        """Resume an interrupted/cancelled/failed job from its checkpoint.
+
+        Batches persisted in the manifest before the interruption are skipped
+        by the content-hash check, so only the remaining files are reindexed.
+        """
+        job = self._jobs.get(job_id)
+        if job is None:
+            raise ValueError(f"Unknown job: {job_id}")
+
+        if job["status"] == "running":
+            return {"job_id": job_id, "status": "running", "resumed": False}
+
+        file_paths = job.get("file_paths") or []
+        if not file_paths:
+            raise ValueError(f"Job {job_id} has no recorded file list to resume")
+
+        job.update({
+            "status": "running",
+            "cancel_requested": False,
+            "processed": 0,
+            "success_count": 0,
+            "skipped_count": 0,
+            "error_count": 0,
+            "errors": [],
+            "started_at": time.time(),
+            "finished_at": None,
+        })
+        self._save_jobs()
+
+        task = asyncio.create_task(self._run_index_job(job_id, file_paths))
+        self._job_tasks[job_id] = task
+        task.add_done_callback(lambda _: self._job_tasks.pop(job_id, None))
+
+        logger.info(f"Resumed index job {job_id} ({len(file_paths)} files, "
+                    f"already-indexed batches will be skipped)")
+        return {"job_id": job_id, "total": len(file_paths),
+                "status": "running", "resumed": True}
+
+    async def cancel_job(self, job_id: str) -> Dict[str, Any]:
+        """Request cancellation of a background indexing job"""
+        job = self._jobs.get(job_id)
+        if job is None:
+            raise ValueError(f"Unknown job: {job_id}")
+
+        if job["status"] != "running":
+            return {"job_id": job_id, "status": job["status"], "cancelled": False}
+
+        # Cooperative: the job stops at the next batch boundary so completed
+        # batches stay durable in the manifest
+        job["cancel_requested"] = True
+        logger.info(f"Cancellation requested for job {job_id}")
+        return {"job_id": job_id, "status": "cancelling", "cancelled": True}
+
     async def insert_text(self, text: str, metadata: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
         """Insert text content directly without a file"""
         await self.initialize()
@@ -152,7 +1146,15 @@ class LightRAGWrapper:
         
         try:
             await self.rag.ainsert(text)
-            
+
+            self._stats["documents"] += 1
+            self._stats["inserted_docs"] += 1
+            self._stats["content_bytes"] += len(text)
+            self._save_stats()
+
+            await self._update_community_summaries()
+            self._bump_index_generation()
+
             return {
                 "success": True,
                 "message": f"Successfully inserted {len(text)} characters"
@@ -166,6 +1168,76 @@ class LightRAGWrapper:
                 "message": error_msg
             }
     
+    async def insert_texts(self, items: List[Dict[str, Any]]) -> Dict[str, Any]:
+        """Insert many text snippets through a single pipeline pass.
+
+        Amortizes the extraction overhead across the batch: one ainsert call
+        covers all items instead of one pipeline run per snippet. Per-item
+        results report which snippets were rejected before the insert.
+        """
+        await self.initialize()
+
+        logger.info(f"Inserting {len(items)} text snippets as one batch")
+
+        results: List[Dict[str, Any]] = []
+        texts: List[str] = []
+        inserted_indices: List[int] = []
+
+        for i, item in enumerate(items):
+            text = item.get("text") if isinstance(item, dict) else None
+            if not text or not isinstance(text, str):
+                results.append({
+                    "success": False,
+                    "message": f"Item {i}: text must be a non-empty string"
+                })
+                continue
+            results.append({
+                "success": True,
+                "message": f"Successfully inserted {len(text)} characters"
+            })
+            texts.append(text)
+            inserted_indices.append(i)
+
+        if texts:
+            try:
+                await self.rag.ainsert(texts)
+
+                self._stats["documents"] += len(texts)
+                self._stats["inserted_docs"] += len(texts)
+                self._stats["content_bytes"] += sum(len(t) for t in texts)
+                self._save_stats()
+
+                await self._update_community_summaries()
+                self._bump_index_generation()
+
+            except Exception as e:
+                error_msg = f"Error inserting batch: {str(e)}"
+                logger.error(error_msg)
+                for i in inserted_indices:
+                    results[i] = {"success": False, "message": error_msg}
+
+        success_count = sum(1 for r in results if r["success"])
+        return {
+            "success_count": success_count,
+            "error_count": len(results) - success_count,
+            "results": results,
+            "total": len(items)
+        }
+
+    async def _notify(self, method: str, params: Dict[str, Any]):
+        """Send a JSON-RPC notification (no id) to the bridge"""
+        message = {
+            "jsonrpc": "2.0",
+            "method": method,
+            "params": params
+        }
+        # Progress updates ride the control channel when it is up, so they
+        # are delivered promptly even while the data pipe is saturated
+        if method == "index_progress" and self._control_writer is not None:
+            await self._write_control_message(message)
+            return
+        await self._write_response(message)
+
     async def search_code(
         self,
         query: str,
@@ -177,17 +1249,19 @@ class LightRAGWrapper:
         max_token_for_global_context: int = 4000,
         max_token_for_local_context: int = 4000,
         hl_keywords: Optional[List[str]] = None,
-        ll_keywords: Optional[List[str]] = None
+        ll_keywords: Optional[List[str]] = None,
+        stream: bool = False,
+        _request_id: Optional[int] = None
     ) -> Dict[str, Any]:
         """Search code using LightRAG"""
         await self.initialize()
-        
-        logger.info(f"Searching: query='{query}', mode={mode}, top_k={top_k}")
+
+        logger.info(f"Searching: query='{query}', mode={mode}, top_k={top_k}, stream={stream}")
         if hl_keywords:
             logger.info(f"High-level keywords: {hl_keywords}")
         if ll_keywords:
             logger.info(f"Low-level keywords: {ll_keywords}")
-        
+
         try:
             # Build QueryParam with advanced options
             query_params = {
@@ -199,131 +1273,926 @@ class LightRAGWrapper:
                 "max_token_for_global_context": max_token_for_global_context,
                 "max_token_for_local_context": max_token_for_local_context
             }
-            
+
             # Add keyword filters if provided
             if hl_keywords:
                 query_params["hl_keywords"] = hl_keywords
             if ll_keywords:
                 query_params["ll_keywords"] = ll_keywords
-            
-            result = await self.rag.aquery(
-                query,
-                param=QueryParam(**query_params)
-            )
-            
-            return {
-                "answer": str(result),
+
+            # Serve repeated questions from the persistent cache; entries are
+            # dropped wholesale whenever the index generation changes
+            cache_key = self._query_cache_key(query, query_params)
+            if not stream:
+                self._refresh_query_cache()
+                cached = self._query_cache["entries"].get(cache_key)
+                if cached is not None:
+                    self._query_cache_hits += 1
+                    logger.info(f"Query cache hit for '{query}' (mode={mode})")
+                    result = dict(cached["result"])
+                    result["cached"] = True
+                    return result
+                self._query_cache_misses += 1
+
+            # Context-only: retrieval without any generation pass, returning
+            # typed chunks/entities/relations instead of a stringified blob
+            if only_context:
+                context, _ = await self._retrieve_context(
+                    query, mode, top_k,
+                    max_token_for_text_unit=max_token_for_text_unit,
+                    hl_keywords=hl_keywords, ll_keywords=ll_keywords)
+                response = {
+                    "answer": "",
+                    "context": context,
+                    "query": query,
+                    "mode": mode,
+                    "top_k": top_k
+                }
+                self._store_query_result(cache_key, response)
+                return response
+
+            # Global mode reads precomputed community summaries (maintained
+            # at insert time) instead of assembling and summarizing the
+            # whole-graph context on every request
+            if mode == "global" and not stream and self._communities["communities"]:
+                answer = await self._answer_from_communities(query, response_type)
+                if answer is not None:
+                    response = {
+                        "answer": str(answer),
+                        "query": query,
+                        "mode": mode,
+                        "top_k": top_k
+                    }
+                    self._store_query_result(cache_key, response)
+                    response["precomputed"] = True
+                    return response
+
+            # Streaming: forward LLM tokens as notifications keyed by the
+            # originating request id, then return the full answer as usual
+            if stream and not only_context and _request_id is not None:
+                query_params["stream"] = True
+                result = await self.rag.aquery(
+                    query,
+                    param=QueryParam(**query_params)
+                )
+
+                if hasattr(result, "__aiter__"):
+                    chunks = []
+                    async for chunk in result:
+                        chunks.append(str(chunk))
+                        await self._notify("search_chunk", {
+                            "id": _request_id,
+                            "chunk": str(chunk)
+                        })
+                    answer = "".join(chunks)
+                else:
+                    # Backend returned a full answer despite stream=True
+                    answer = str(result)
+
+                response = {
+                    "answer": answer,
+                    "query": query,
+                    "mode": mode,
+                    "top_k": top_k
+                }
+                self._store_query_result(cache_key, response)
+                response["streamed"] = True
+                return response
+
+            # Retrieve structured context once — honoring the keyword
+            # filters and all three token budgets — post-process it (dedupe
+            # near-identical text units, merge same-file spans, pack), and
+            # generate from the packed result. The native pipeline is kept
+            # only as a fallback for when retrieval comes back empty
+            context, dropped = await self._retrieve_context(
+                query, mode, top_k,
+                max_token_for_text_unit=max_token_for_text_unit,
+                max_token_for_global_context=max_token_for_global_context,
+                max_token_for_local_context=max_token_for_local_context,
+                hl_keywords=hl_keywords, ll_keywords=ll_keywords)
+
+            if context["chunks"] or context["entities"] or context["relations"]:
+                if dropped:
+                    logger.info(f"Context packing dropped {dropped} duplicate block(s)")
+                answer = await self._tracked_llm_complete(
+                    self.openai_model,
+                    (f"Context from the codebase knowledge graph:\n\n"
+                     f"{self._render_context(context)}\n\n"
+                     f"Question: {query}\n\n"
+                     f"Respond as: {response_type}"),
+                    system_prompt=(
+                        "You are a code search assistant. Answer using only "
+                        "the provided context; say so when it is insufficient."
+                    ),
+                    api_key=self.openai_api_key,
+                    base_url=self.openai_base_url,
+                )
+            else:
+                # Empty retrieval (fresh index, exotic mode): native path
+                answer = await self.rag.aquery(
+                    query,
+                    param=QueryParam(**query_params)
+                )
+
+            response = {
+                "answer": str(answer),
                 "query": query,
                 "mode": mode,
                 "top_k": top_k
             }
-            
+            self._store_query_result(cache_key, response)
+            return response
+
         except Exception as e:
             logger.error(f"Search error: {str(e)}")
             raise
+
+    async def _retrieve_context(
+        self, query: str, mode: str, top_k: int,
+        max_token_for_text_unit: int = 4000,
+        max_token_for_global_context: int = 4000,
+        max_token_for_local_context: int = 4000,
+        hl_keywords: Optional[List[str]] = None,
+        ll_keywords: Optional[List[str]] = None
+    ) -> tuple:
+        """Vector/graph retrieval without generation.
+
+        Keyword filters mirror the native pipeline's split: low-level
+        keywords steer entity retrieval, high-level keywords steer relation
+        retrieval; absent either, the raw query is used. The three token
+        budgets cap text units, relations (global context), and entities
+        (local context) respectively, at the usual ~4 chars/token estimate.
+
+        Returns (context, dropped): structured context arrays plus the
+        number of near-duplicate text units dedupe removed.
+        """
+        graph = self.rag.chunk_entity_relation_graph
+        context: Dict[str, List[Dict[str, Any]]] = {
+            "chunks": [],
+            "entities": [],
+            "relations": []
+        }
+
+        # Text chunks via vector search (all modes except pure-global)
+        if mode != "global":
+            try:
+                matches = await self.rag.chunks_vdb.query(query, top_k=top_k) or []
+                for match in matches:
+                    chunk_id = match.get("id")
+                    chunk = await self.rag.text_chunks.get_by_id(chunk_id) if chunk_id else None
+                    if chunk:
+                        context["chunks"].append({
+                            "id": chunk_id,
+                            "content": chunk.get("content", ""),
+                            "file_path": chunk.get("file_path", ""),
+                            "score": match.get("distance", match.get("score"))
+                        })
+            except Exception as e:
+                logger.warning(f"Chunk retrieval failed: {e}")
+
+        # Entities via the entity vector index plus graph metadata
+        if mode != "naive":
+            try:
+                entity_query = ", ".join(ll_keywords) if ll_keywords else query
+                matches = await self.rag.entities_vdb.query(entity_query, top_k=top_k) or []
+                for match in matches:
+                    entity_name = match.get("entity_name")
+                    if not entity_name:
+                        continue
+                    node = await graph.get_node(entity_name) or {}
+                    context["entities"].append({
+                        "name": entity_name,
+                        "entity_type": node.get("entity_type", "unknown"),
+                        "description": node.get("description", ""),
+                        "source_id": node.get("source_id", "")
+                    })
+            except Exception as e:
+                logger.warning(f"Entity retrieval failed: {e}")
+
+        # Relations for global/hybrid/mix modes
+        if mode in ("global", "hybrid", "mix"):
+            try:
+                relation_query = ", ".join(hl_keywords) if hl_keywords else query
+                matches = await self.rag.relationships_vdb.query(relation_query, top_k=top_k) or []
+                for match in matches:
+                    src = match.get("src_id")
+                    tgt = match.get("tgt_id")
+                    if not src or not tgt:
+                        continue
+                    edge = await graph.get_edge(src, tgt) or {}
+                    context["relations"].append({
+                        "source": src,
+                        "target": tgt,
+                        "description": edge.get("description", ""),
+                        "keywords": edge.get("keywords", ""),
+                        "weight": edge.get("weight", 0)
+                    })
+            except Exception as e:
+                logger.warning(f"Relation retrieval failed: {e}")
+
+        # Post-process before anything reaches a prompt: dedupe overlapping
+        # text units, merge adjacent same-file spans, pack to the budget
+        context["chunks"], dropped = self._postprocess_chunks(
+            context["chunks"], max_chars=max_token_for_text_unit * 4)
+
+        unique_entities: Dict[str, Dict[str, Any]] = {}
+        for entity in context["entities"]:
+            unique_entities.setdefault(entity["name"], entity)
+        context["entities"] = self._pack_to_budget(
+            list(unique_entities.values()),
+            max_token_for_local_context * 4,
+            lambda e: len(e["name"]) + len(e["description"]))
+
+        unique_relations: Dict[tuple, Dict[str, Any]] = {}
+        for relation in context["relations"]:
+            unique_relations.setdefault((relation["source"], relation["target"]), relation)
+        context["relations"] = self._pack_to_budget(
+            list(unique_relations.values()),
+            max_token_for_global_context * 4,
+            lambda r: len(r["source"]) + len(r["target"]) + len(r["description"]))
+
+        return context, dropped
+
+    @staticmethod
+    def _pack_to_budget(items: list, max_chars: int, measure) -> list:
+        """Keep items in retrieval order until the character budget is spent"""
+        packed = []
+        used = 0
+        for item in items:
+            length = measure(item)
+            if used + length > max_chars and packed:
+                break
+            packed.append(item)
+            used += length
+        return packed
+
+    # Matches the per-chunk header emitted by chunk_cpp_source
+    _CHUNK_HEADER_RE = re.compile(r"^// File: (.+) \(lines (\d+)-(\d+)\)")
+
+    @staticmethod
+    def _dedupe_blocks(blocks: List[str]) -> tuple:
+        """Drop exact and near-duplicate text blocks, preserving order.
+
+        Near-duplicates are detected with 8-word shingle overlap, which
+        catches the same function body retrieved via both the vector and
+        graph paths even when surrounding headers differ.
+        """
+        kept = []
+        seen_hashes = set()
+        seen_shingles: List[set] = []
+        dropped = 0
+
+        for block in blocks:
+            normalized = " ".join(block.split()).lower()
+            block_hash = hashlib.md5(normalized.encode('utf-8')).hexdigest()
+            if block_hash in seen_hashes:
+                dropped += 1
+                continue
+
+            words = normalized.split()
+            if len(words) >= 8:
+                shingles = {" ".join(words[i:i + 8]) for i in range(len(words) - 7)}
+            else:
+                shingles = {normalized}
+
+            if any(shingles and seen and
+                   len(shingles & seen) / min(len(shingles), len(seen)) > 0.85
+                   for seen in seen_shingles):
+                dropped += 1
+                continue
+
+            seen_hashes.add(block_hash)
+            seen_shingles.append(shingles)
+            kept.append(block)
+
+        return kept, dropped
+
+    @staticmethod
+    def _render_context(context: Dict[str, Any]) -> str:
+        """Render structured retrieval output into prompt text"""
+        parts = [chunk["content"] for chunk in context.get("chunks", [])
+                 if chunk.get("content")]
+
+        if context.get("entities"):
+            lines = ["Entities:"]
+            for entity in context["entities"]:
+                lines.append(f"- {entity['name']} ({entity['entity_type']}): "
+                             f"{entity['description']}")
+            parts.append("\n".join(lines))
+
+        if context.get("relations"):
+            lines = ["Relations:"]
+            for relation in context["relations"]:
+                lines.append(f"- {relation['source']} -> {relation['target']}: "
+                             f"{relation['description']}")
+            parts.append("\n".join(lines))
+
+        return "\n\n".join(parts)
+
+    def _postprocess_chunks(
+        self, chunks: List[Dict[str, Any]], max_chars: int
+    ) -> tuple:
+        """Dedupe, merge same-file spans, and pack retrieved chunks.
+
+        Returns (packed, dropped) where dropped counts removed duplicates.
+        """
+        contents = [c.get("content", "") for c in chunks]
+        kept_contents, dropped = self._dedupe_blocks(contents)
+        kept_set = set(kept_contents)
+        deduped = [c for c in chunks if c.get("content", "") in kept_set]
+
+        # Merge consecutive chunks from the same file into one span so the
+        # prompt carries one header per file region instead of one per chunk
+        merged: List[Dict[str, Any]] = []
+        for chunk in deduped:
+            prev = merged[-1] if merged else None
+            if (prev is not None and chunk.get("file_path")
+                    and chunk["file_path"] == prev.get("file_path")):
+                content = self._CHUNK_HEADER_RE.sub(
+                    "", chunk.get("content", ""), count=1).lstrip("\n")
+                prev["content"] = prev["content"].rstrip() + "\n\n" + content
+            else:
+                merged.append(dict(chunk))
+
+        packed: List[Dict[str, Any]] = []
+        used = 0
+        for chunk in merged:
+            length = len(chunk.get("content", ""))
+            if used + length > max_chars and packed:
+                break
+            packed.append(chunk)
+            used += length
+
+        return packed, dropped
+
+    def _store_query_result(self, cache_key: str, result: Dict[str, Any]):
+        """Store a search result in the persistent query cache"""
+        # Re-sync first so a save never clobbers a sibling's generation bump
+        self._refresh_query_cache()
+        entries = self._query_cache["entries"]
+        entries[cache_key] = {"result": dict(result), "created_at": time.time()}
+
+        # Evict oldest entries beyond the size bound
+        if len(entries) > QUERY_CACHE_MAX_ENTRIES:
+            for key in sorted(entries, key=lambda k: entries[k]["created_at"])[
+                    :len(entries) - QUERY_CACHE_MAX_ENTRIES]:
+                del entries[key]
+
+        self._save_query_cache()
     
+    async def _resolve_entity(self, entity_name: str) -> Optional[str]:
+        """Resolve a user-supplied name to a node id in the knowledge graph"""
+        graph = self.rag.chunk_entity_relation_graph
+
+        # Entity ids vary by LightRAG version (as-is, upper-cased, quoted)
+        for candidate in (entity_name, entity_name.upper(), f'"{entity_name.upper()}"'):
+            if await graph.has_node(candidate):
+                return candidate
+        return None
+
     async def get_entity(self, entity_name: str) -> Dict[str, Any]:
-        """Get details about a specific entity"""
+        """Get entity details directly from graph storage (no LLM round trip)"""
         await self.initialize()
-        
+
         logger.info(f"Getting entity: {entity_name}")
-        
-        result = await self.rag.aquery(
-            f"Describe the entity '{entity_name}' in detail. Include its purpose, methods, and usage.",
-            param=QueryParam(mode="local", only_need_context=True, top_k=10)
-        )
-        
+
+        graph = self.rag.chunk_entity_relation_graph
+        node_id = await self._resolve_entity(entity_name)
+
+        if node_id is None:
+            return {
+                "entity_name": entity_name,
+                "found": False,
+                "description": f"Entity '{entity_name}' not found in the knowledge graph"
+            }
+
+        node = await graph.get_node(node_id) or {}
+        edges = await graph.get_node_edges(node_id) or []
+
         return {
             "entity_name": entity_name,
-            "description": str(result),
-            "search_mode": "local"
+            "found": True,
+            "entity_type": node.get("entity_type", "unknown"),
+            "description": node.get("description", ""),
+            "source_id": node.get("source_id", ""),
+            "degree": len(edges)
         }
-    
+
     async def get_relationships(
         self,
         entity_name: str,
         relation_type: Optional[str] = None,
         depth: int = 1
     ) -> Dict[str, Any]:
-        """Get relationships for an entity"""
+        """Get relationships via bounded BFS over graph storage (no LLM round trip)"""
         await self.initialize()
-        
+
         logger.info(f"Getting relationships: entity={entity_name}, type={relation_type}, depth={depth}")
-        
-        # Build query based on relation type
-        if relation_type:
-            query = f"What {relation_type} relationships does '{entity_name}' have? Show dependencies up to depth {depth}."
-        else:
-            query = f"What are all the relationships for '{entity_name}'? Include calls, inheritance, and dependencies up to depth {depth}."
-        
-        result = await self.rag.aquery(
-            query,
-            param=QueryParam(mode="local", top_k=20)
-        )
-        
+
+        graph = self.rag.chunk_entity_relation_graph
+        node_id = await self._resolve_entity(entity_name)
+
+        if node_id is None:
+            return {
+                "entity_name": entity_name,
+                "found": False,
+                "relation_type": relation_type or "all",
+                "depth": depth,
+                "relationships": []
+            }
+
+        relationships = []
+        visited = {node_id}
+        frontier = [node_id]
+
+        for current_depth in range(1, max(1, depth) + 1):
+            next_frontier = []
+
+            for source in frontier:
+                edges = await graph.get_node_edges(source) or []
+
+                for edge_source, edge_target in edges:
+                    edge = await graph.get_edge(edge_source, edge_target) or {}
+
+                    # Edges carry free-text keywords/description rather than a
+                    # typed relation, so relation_type filters by keyword match
+                    if relation_type:
+                        haystack = (
+                            f"{edge.get('keywords', '')} {edge.get('description', '')}"
+                        ).lower()
+                        if relation_type.replace('_', ' ') not in haystack \
+                                and relation_type.lower() not in haystack:
+                            continue
+
+                    relationships.append({
+                        "source": edge_source,
+                        "target": edge_target,
+                        "description": edge.get("description", ""),
+                        "keywords": edge.get("keywords", ""),
+                        "weight": edge.get("weight", 0),
+                        "depth": current_depth
+                    })
+
+                    neighbor = edge_target if edge_source == source else edge_source
+                    if neighbor not in visited:
+                        visited.add(neighbor)
+                        next_frontier.append(neighbor)
+
+            frontier = next_frontier
+
         return {
             "entity_name": entity_name,
+            "found": True,
             "relation_type": relation_type or "all",
             "depth": depth,
-            "relationships": str(result)
+            "relationships": relationships
         }
     
+    async def _find_seed_entities(self, query: str, top_k: int = 5) -> List[str]:
+        """Resolve a query to seed entities in the knowledge graph"""
+        graph = self.rag.chunk_entity_relation_graph
+        seeds = []
+
+        # Prefer the entity vector index for semantic matching
+        try:
+            matches = await self.rag.entities_vdb.query(query, top_k=top_k)
+            for match in matches or []:
+                entity_name = match.get("entity_name")
+                if entity_name and await graph.has_node(entity_name):
+                    seeds.append(entity_name)
+        except Exception as e:
+            logger.warning(f"Entity vector lookup failed, falling back to name match: {e}")
+
+        # Fall back to matching query terms against node ids directly
+        if not seeds:
+            for word in re.findall(r"[A-Za-z_][A-Za-z0-9_:]*", query):
+                node_id = await self._resolve_entity(word)
+                if node_id and node_id not in seeds:
+                    seeds.append(node_id)
+
+        return seeds
+
+    @staticmethod
+    def _mermaid_id(node_id: str) -> str:
+        """Sanitize a graph node id into a valid Mermaid identifier"""
+        return re.sub(r"[^A-Za-z0-9_]", "_", node_id.strip('"')) or "node"
+
     async def visualize_subgraph(
         self,
         query: str,
         format: str = "mermaid",
         max_nodes: int = 20
     ) -> Dict[str, Any]:
-        """Generate visualization of code relationships"""
+        """Extract and render the actual subgraph around entities matching the query"""
         await self.initialize()
-        
+
         logger.info(f"Visualizing: query='{query}', format={format}, max_nodes={max_nodes}")
-        
+
         # Validate format
         if format != "mermaid":
             raise ValueError(f"Unsupported format '{format}'. Only 'mermaid' format is supported.")
-        
-        # Get entities and relationships
-        result = await self.rag.aquery(
-            f"{query}. List all entities and their relationships.",
-            param=QueryParam(mode="hybrid", top_k=max_nodes)
-        )
-        
-        # Generate Mermaid diagram
-        # Note: This is a simplified version - in production, you'd parse the graph structure
+
+        graph = self.rag.chunk_entity_relation_graph
+        seeds = await self._find_seed_entities(query)
+
+        if not seeds:
+            return {
+                "query": query,
+                "format": format,
+                "diagram": f"graph TD\n    Empty[\"No entities matched '{query}'\"]\n",
+                "max_nodes": max_nodes,
+                "node_count": 0,
+                "edge_count": 0
+            }
+
+        # Bounded BFS from the seeds, collecting candidates with their degree
+        candidates: Dict[str, int] = {}
+        frontier = list(seeds)
+        visited = set(seeds)
+
+        while frontier and len(candidates) < max_nodes * 4:
+            next_frontier = []
+            for node_id in frontier:
+                degree = await graph.node_degree(node_id)
+                candidates[node_id] = degree
+
+                edges = await graph.get_node_edges(node_id) or []
+                for edge_source, edge_target in edges:
+                    neighbor = edge_target if edge_source == node_id else edge_source
+                    if neighbor not in visited:
+                        visited.add(neighbor)
+                        next_frontier.append(neighbor)
+            frontier = next_frontier
+
+        # Seeds always stay; the rest are ranked by degree to respect max_nodes
+        selected = set(seeds)
+        for node_id, _ in sorted(candidates.items(), key=lambda item: -item[1]):
+            if len(selected) >= max_nodes:
+                break
+            selected.add(node_id)
+
+        # Collect edges between selected nodes
+        diagram_edges = []
+        seen_pairs = set()
+        for node_id in selected:
+            edges = await graph.get_node_edges(node_id) or []
+            for edge_source, edge_target in edges:
+                if edge_source not in selected or edge_target not in selected:
+                    continue
+                pair = tuple(sorted((edge_source, edge_target)))
+                if pair in seen_pairs:
+                    continue
+                seen_pairs.add(pair)
+
+                edge = await graph.get_edge(edge_source, edge_target) or {}
+                keywords = str(edge.get("keywords", "")).strip()
+                diagram_edges.append((edge_source, edge_target, keywords[:40]))
+
+        # Emit Mermaid
         diagram = "graph TD\n"
-        diagram += f"    Query[\"{query}\"]\n"
-        diagram += f"    Result[\"{str(result)[:100]}...\"]\n"
-        diagram += "    Query --> Result\n"
-        
+        for node_id in sorted(selected):
+            label = node_id.strip('"')
+            diagram += f"    {self._mermaid_id(node_id)}[\"{label}\"]\n"
+        for edge_source, edge_target, keywords in diagram_edges:
+            arrow = f"-->|{keywords}|" if keywords else "-->"
+            diagram += f"    {self._mermaid_id(edge_source)} {arrow} {self._mermaid_id(edge_target)}\n"
+
         return {
             "query": query,
             "format": format,
             "diagram": diagram,
-            "max_nodes": max_nodes
+            "max_nodes": max_nodes,
+            "node_count": len(selected),
+            "edge_count": len(diagram_edges)
         }
     
+    def _export_bundle_sync(self, output_path: str) -> Dict[str, Any]:
+        """Snapshot the working directory into a compressed bundle file"""
+        output = Path(output_path)
+        output.parent.mkdir(parents=True, exist_ok=True)
+
+        metadata = {
+            "bundle_format": BUNDLE_FORMAT_VERSION,
+            "created_at": time.time(),
+            "documents": self._stats["documents"],
+            "manifest_entries": len(self._manifest),
+        }
+
+        file_count = 0
+        with tarfile.open(output, "w:gz") as tar:
+            for path in sorted(self.working_dir.rglob('*')):
+                # Skip in-progress atomic-write temp files
+                if not path.is_file() or path.suffix == '.tmp':
+                    continue
+                tar.add(path, arcname=path.relative_to(self.working_dir).as_posix())
+                file_count += 1
+
+            payload = json.dumps(metadata).encode('utf-8')
+            info = tarfile.TarInfo("bundle_manifest.json")
+            info.size = len(payload)
+            tar.addfile(info, io.BytesIO(payload))
+
+        return {
+            "bundle_path": str(output),
+            "bundle_format": BUNDLE_FORMAT_VERSION,
+            "files": file_count,
+            "size_bytes": output.stat().st_size,
+            "documents": self._stats["documents"],
+        }
+
+    def _import_bundle_sync(self, bundle: Path) -> Dict[str, Any]:
+        """Extract a bundle into the working directory after validating it"""
+        if not bundle.exists():
+            raise ValueError(f"Bundle not found: {bundle}")
+
+        with tarfile.open(bundle, "r:gz") as tar:
+            try:
+                manifest_member = tar.getmember("bundle_manifest.json")
+            except KeyError:
+                raise ValueError(f"Not an index bundle (no bundle_manifest.json): {bundle}")
+
+            metadata = json.load(tar.extractfile(manifest_member))
+            if metadata.get("bundle_format") != BUNDLE_FORMAT_VERSION:
+                raise ValueError(
+                    f"Unsupported bundle format {metadata.get('bundle_format')} "
+                    f"(expected {BUNDLE_FORMAT_VERSION})")
+
+            for member in tar.getmembers():
+                if member.name == "bundle_manifest.json":
+                    continue
+                # Refuse anything that would escape the working directory
+                if member.name.startswith('/') or '..' in Path(member.name).parts:
+                    logger.warning(f"Skipping unsafe bundle entry: {member.name}")
+                    continue
+                # filter="data" additionally rejects symlinks, devices and
+                # other non-file members a crafted bundle could carry
+                tar.extract(member, self.working_dir, filter="data")
+
+        return metadata
+
+    def _reload_persisted_state(self):
+        """Re-read all persisted state after a bundle restore"""
+        self._manifest = self._load_manifest()
+        self._query_cache = self._load_query_cache()
+        self._embedding_cache = self._load_embedding_cache()
+        self._stats = self._load_stats()
+        self._communities = self._load_communities()
+        self._known_nodes = set(self._communities.get("nodes", []))
+        self._jobs = self._load_jobs()
+        self._status_snapshot = None
+
+    async def export_index_bundle(self, output_path: str) -> Dict[str, Any]:
+        """Export the index as a single compressed, versioned bundle.
+
+        Built in the lab, shipped to air-gapped sites, and restored there
+        via import_index_bundle or LIGHTRAG_INDEX_BUNDLE at startup.
+        """
+        await self.initialize()
+
+        logger.info(f"Exporting index bundle to {output_path}")
+        loop = asyncio.get_event_loop()
+        result = await loop.run_in_executor(None, self._export_bundle_sync, output_path)
+        logger.info(f"Bundle exported: {result['files']} files, "
+                    f"{result['size_bytes']} bytes")
+        return result
+
+    async def import_index_bundle(
+        self, bundle_path: str, force: bool = False
+    ) -> Dict[str, Any]:
+        """Restore an exported bundle into this wrapper's working directory"""
+        if self._manifest and not force:
+            raise ValueError(
+                "Working directory already contains an index; "
+                "pass force=true to overwrite it")
+
+        logger.info(f"Importing index bundle from {bundle_path}")
+        loop = asyncio.get_event_loop()
+        metadata = await loop.run_in_executor(
+            None, self._import_bundle_sync, Path(bundle_path))
+
+        # Drop the live instance so the next request initializes against
+        # the restored files
+        self.rag = None
+        self._initialized = False
+        self._reload_persisted_state()
+
+        return {
+            "imported": True,
+            "bundle_path": bundle_path,
+            "manifest_entries": len(self._manifest),
+            "documents": self._stats["documents"],
+            "created_at": metadata.get("created_at"),
+        }
+
+    def _collect_storage_snapshot(self) -> Dict[str, Any]:
+        """Walk the working directory and count graph nodes/edges.
+
+        This is the expensive part of status reporting, so it runs at most
+        once per index generation; repeated polls are served from memory.
+        """
+        working_dir_size = 0
+        try:
+            working_dir_size = sum(
+                f.stat().st_size for f in self.working_dir.rglob('*') if f.is_file()
+            )
+        except Exception as e:
+            logger.warning(f"Could not measure working directory size: {e}")
+
+        entity_count = 0
+        relation_count = 0
+        try:
+            graph = getattr(self.rag.chunk_entity_relation_graph, "_graph", None)
+            if graph is not None:
+                entity_count = graph.number_of_nodes()
+                relation_count = graph.number_of_edges()
+        except Exception as e:
+            logger.debug(f"Could not count graph nodes/edges: {e}")
+
+        # LightRAG's actual text-chunk count, straight from the KV storage
+        chunk_count = 0
+        try:
+            chunk_data = getattr(self.rag.text_chunks, "_data", None)
+            if chunk_data is not None:
+                chunk_count = len(chunk_data)
+        except Exception as e:
+            logger.debug(f"Could not count text chunks: {e}")
+
+        return {
+            "working_dir_size_bytes": working_dir_size,
+            "entity_count": entity_count,
+            "relation_count": relation_count,
+            "chunk_count": chunk_count,
+        }
+
     async def get_indexing_status(self) -> Dict[str, Any]:
         """Get indexing status and metadata"""
         await self.initialize()
-        
+
         logger.info("Getting indexing status")
-        
-        # Get storage statistics
-        working_dir_size = sum(
-            f.stat().st_size for f in self.working_dir.rglob('*') if f.is_file()
-        )
-        
+
+        # Pick up state written by sibling pool processes before reporting
+        self._refresh_query_cache()
+        self._refresh_stats()
+
+        # Refresh the storage snapshot only when the index has changed since
+        # the last status call; dashboards polling every 30 s hit the cache
+        generation = self._query_cache["generation"]
+        if self._status_snapshot is None or self._status_snapshot_generation != generation:
+            self._status_snapshot = self._collect_storage_snapshot()
+            self._status_snapshot_generation = generation
+        snapshot = self._status_snapshot
+
         return {
             "initialized": self._initialized,
             "working_dir": str(self.working_dir),
-            "working_dir_size_bytes": working_dir_size,
+            "working_dir_size_bytes": snapshot["working_dir_size_bytes"],
+            "index_stats": {
+                "documents": self._stats["documents"],
+                "inserted_docs": self._stats["inserted_docs"],
+                "chunks": snapshot["chunk_count"],
+                "content_bytes": self._stats["content_bytes"],
+                "entities": snapshot["entity_count"],
+                "relations": snapshot["relation_count"],
+            },
             "storage_backends": {
                 "milvus": self.milvus_address or "NanoVectorDB",
                 "neo4j": self.neo4j_uri or "NetworkX"
+            },
+            "backend_pools": {
+                name: {
+                    **health,
+                    # Saturation gauge: requests currently competing for
+                    # the backend's connection pool
+                    "in_flight_requests": self._in_flight,
+                }
+                for name, health in self._backend_health.items()
+            },
+            "query_cache": {
+                "generation": self._query_cache["generation"],
+                "entries": len(self._query_cache["entries"]),
+                "hits": self._query_cache_hits,
+                "misses": self._query_cache_misses
+            },
+            "embedding_cache": {
+                "entries": len(self._embedding_cache),
+                "hits": self._embedding_cache_hits,
+                "misses": self._embedding_cache_misses
             }
         }
     
+    async def _tracked_llm_complete(self, *args, **kwargs):
+        """Pass-through to openai_complete_if_cache with call/token accounting"""
+        self._llm_calls += 1
+        result = await openai_complete_if_cache(*args, **kwargs)
+
+        try:
+            prompt_chars = sum(len(str(a)) for a in args)
+            prompt_chars += len(str(kwargs.get("system_prompt") or ""))
+            # Rough chars/4 token estimate; good enough for trend tracking
+            self._llm_est_tokens += (prompt_chars + len(str(result))) // 4
+        except Exception:
+            pass
+
+        return result
+
+    def _record_method_sample(self, method: str, duration_ms: float):
+        """Record a handler latency sample for percentile reporting"""
+        samples = self._method_samples.setdefault(method, [])
+        samples.append(duration_ms)
+        if len(samples) > METRICS_MAX_SAMPLES:
+            del samples[:len(samples) - METRICS_MAX_SAMPLES]
+
+    async def get_metrics(self) -> Dict[str, Any]:
+        """Latency histograms, backend call counters, and in-flight gauge"""
+        methods = {}
+        for method, samples in self._method_samples.items():
+            if not samples:
+                continue
+            methods[method] = {
+                "count": len(samples),
+                "avg_ms": round(sum(samples) / len(samples), 2),
+                "p50_ms": round(_percentile(samples, 0.50), 2),
+                "p95_ms": round(_percentile(samples, 0.95), 2),
+                "p99_ms": round(_percentile(samples, 0.99), 2),
+            }
+
+        return {
+            "methods": methods,
+            "in_flight": self._in_flight,
+            "llm": {
+                "calls": self._llm_calls,
+                "estimated_tokens": self._llm_est_tokens
+            },
+            "embedding": {
+                "api_calls": self._embedding_api_calls,
+                "texts_embedded": self._embedding_texts,
+                "cache_hits": self._embedding_cache_hits,
+                "cache_misses": self._embedding_cache_misses
+            },
+            "query_cache": {
+                "hits": self._query_cache_hits,
+                "misses": self._query_cache_misses
+            }
+        }
+
+    def _resolve_workspace(self, workspace: Optional[str]) -> "LightRAGWrapper":
+        """Route a request to the wrapper owning the named workspace.
+
+        The default (unnamed) workspace is this wrapper itself. Named
+        workspaces get their own child wrapper -- with its own manifest,
+        caches, and LightRAG instance -- kept warm in an LRU bounded by
+        max_warm_workspaces.
+        """
+        if not workspace or workspace == "default":
+            return self
+
+        existing = self._workspace_lru.get(workspace)
+        if existing is not None:
+            self._workspace_lru.move_to_end(workspace)
+            return existing
+
+        working_dir = self.workspaces.get(workspace)
+        if working_dir is None:
+            raise ValueError(f"Unknown workspace: {workspace}")
+
+        child = LightRAGWrapper(
+            working_dir=working_dir,
+            openai_api_key=self.openai_api_key,
+            openai_base_url=self.openai_base_url,
+            openai_model=self.openai_model,
+            openai_embedding_model=self.openai_embedding_model,
+            milvus_address=self.milvus_address,
+            neo4j_uri=self.neo4j_uri,
+            neo4j_username=self.neo4j_username,
+            neo4j_password=self.neo4j_password,
+            max_concurrent_requests=self.max_concurrent_requests,
+            insert_batch_size=self.insert_batch_size,
+            file_read_concurrency=self.file_read_concurrency,
+            framing="length-prefixed" if self._use_binary_framing else "ndjson",
+            backend_pool_size=self.backend_pool_size,
+            backend_warmup=self.backend_warmup,
+        )
+        # Children share the parent's stdout lock so frames from different
+        # workspaces never interleave on the wire
+        child._stdout_lock = self._stdout_lock
+
+        self._workspace_lru[workspace] = child
+        self._evict_cold_workspaces()
+        logger.info(f"Warmed workspace '{workspace}' ({working_dir})")
+        return child
+
+    def _evict_cold_workspaces(self):
+        """Drop least-recently-used workspaces over the warm bound"""
+        while len(self._workspace_lru) > self.max_warm_workspaces:
+            for name in self._workspace_lru:
+                if not self._workspace_lru[name]._job_tasks:
+                    del self._workspace_lru[name]
+                    logger.info(f"Evicted cold workspace '{name}'")
+                    break
+            else:
+                # Every warm workspace has running jobs; keep them all
+                break
+
     async def ping(self) -> str:
         """Health check"""
         return "pong"
@@ -333,26 +2202,46 @@ class LightRAGWrapper:
         jsonrpc = request.get("jsonrpc", "2.0")
         request_id = request.get("id")
         method = request.get("method")
-        params = request.get("params", {})
-        
+        params = dict(request.get("params", {}))
+
         try:
+            # An optional workspace name routes the call to a warm child
+            # wrapper; requests without one stay on this (default) wrapper
+            target = self._resolve_workspace(params.pop("workspace", None))
+
             # Route to appropriate handler
             if method == "ping":
                 result = await self.ping()
             elif method == "index_files":
-                result = await self.index_files(**params)
+                result = await target.index_files(**params)
+            elif method == "start_index_job":
+                result = await target.start_index_job(**params)
+            elif method == "get_job_status":
+                result = await target.get_job_status(**params)
+            elif method == "resume_index_job":
+                result = await target.resume_index_job(**params)
+            elif method == "cancel_job":
+                result = await target.cancel_job(**params)
             elif method == "search_code":
-                result = await self.search_code(**params)
+                result = await target.search_code(_request_id=request_id, **params)
             elif method == "get_entity":
-                result = await self.get_entity(**params)
+                result = await target.get_entity(**params)
             elif method == "get_relationships":
-                result = await self.get_relationships(**params)
+                result = await target.get_relationships(**params)
             elif method == "visualize_subgraph":
-                result = await self.visualize_subgraph(**params)
+                result = await target.visualize_subgraph(**params)
             elif method == "get_indexing_status":
-                result = await self.get_indexing_status()
+                result = await target.get_indexing_status()
+            elif method == "get_metrics":
+                result = await target.get_metrics()
             elif method == "insert_text":
-                result = await self.insert_text(**params)
+                result = await target.insert_text(**params)
+            elif method == "insert_texts":
+                result = await target.insert_texts(**params)
+            elif method == "export_index_bundle":
+                result = await target.export_index_bundle(**params)
+            elif method == "import_index_bundle":
+                result = await target.import_index_bundle(**params)
             else:
                 raise ValueError(f"Unknown method: {method}")
             
@@ -374,35 +2263,182 @@ class LightRAGWrapper:
                 }
             }
     
+    async def _write_response(self, response: Dict[str, Any]):
+        """Write a JSON-RPC response to stdout (serialized across concurrent tasks)"""
+        async with self._stdout_lock:
+            if self._use_binary_framing:
+                payload = json.dumps(response).encode("utf-8")
+                sys.stdout.buffer.write(struct.pack(">I", len(payload)))
+                sys.stdout.buffer.write(payload)
+                sys.stdout.buffer.flush()
+            else:
+                sys.stdout.write(json.dumps(response) + "\n")
+                sys.stdout.flush()
+
+    def _read_frame_sync(self) -> Optional[str]:
+        """Read one length-prefixed frame from stdin; None on EOF"""
+        header = sys.stdin.buffer.read(4)
+        if len(header) < 4:
+            return None
+
+        (length,) = struct.unpack(">I", header)
+        payload = b""
+        while len(payload) < length:
+            piece = sys.stdin.buffer.read(length - len(payload))
+            if not piece:
+                return None
+            payload += piece
+
+        return payload.decode("utf-8")
+
+    # Methods allowed on the control channel: all O(1) lookups or flag
+    # flips, so servicing them serially never stalls a liveness check
+    CONTROL_METHODS = ("ping", "get_job_status", "cancel_job", "get_metrics")
+
+    async def _write_control_message(self, message: Dict[str, Any]):
+        """Write an NDJSON message to the control channel (fd 4)"""
+        async with self._control_lock:
+            self._control_writer.write(json.dumps(message) + "\n")
+            self._control_writer.flush()
+
+    async def _run_control_channel(self):
+        """Service control requests on fds 3/4, independent of the data plane.
+
+        The main loop reads one (possibly multi-MB) frame at a time from
+        stdin; this task has its own descriptor pair, so a ping is answered
+        in constant time regardless of data-plane load.
+        """
+        try:
+            reader = os.fdopen(3, "r", encoding="utf-8")
+            self._control_writer = os.fdopen(4, "w", encoding="utf-8")
+        except OSError as e:
+            logger.warning(f"Control channel unavailable: {e}")
+            return
+
+        logger.info("Control channel listening on fds 3/4")
+        loop = asyncio.get_event_loop()
+
+        while True:
+            line = await loop.run_in_executor(None, reader.readline)
+            if not line:
+                logger.info("Control channel EOF")
+                break
+
+            line = line.strip()
+            if not line:
+                continue
+
+            try:
+                request = json.loads(line)
+            except json.JSONDecodeError as e:
+                await self._write_control_message({
+                    "jsonrpc": "2.0",
+                    "id": None,
+                    "error": {"code": -32700, "message": "Parse error", "data": str(e)}
+                })
+                continue
+
+            method = request.get("method")
+            if method not in self.CONTROL_METHODS:
+                await self._write_control_message({
+                    "jsonrpc": "2.0",
+                    "id": request.get("id"),
+                    "error": {
+                        "code": -32601,
+                        "message": f"Method not allowed on control channel: {method}"
+                    }
+                })
+                continue
+
+            # Control requests run immediately -- never behind the semaphore
+            response = await self.handle_request(request)
+            await self._write_control_message(response)
+
+    async def _dispatch_request(self, request: Dict[str, Any]):
+        """Run a single request as an independent task and write its response"""
+        method = request.get("method")
+
+        start = time.perf_counter()
+        self._in_flight += 1
+        try:
+            # Health pings bypass the concurrency limit so they stay
+            # responsive while long-running jobs occupy worker slots
+            if method == "ping":
+                response = await self.handle_request(request)
+            else:
+                async with self._request_semaphore:
+                    response = await self.handle_request(request)
+        finally:
+            self._in_flight -= 1
+            if method:
+                self._record_method_sample(method, (time.perf_counter() - start) * 1000)
+
+        await self._write_response(response)
+
+    async def _eager_initialize(self):
+        """Initialize LightRAG in the background and signal readiness"""
+        try:
+            await self.initialize()
+            await self._notify("ready", {"ok": True})
+        except Exception as e:
+            logger.error(f"Eager initialization failed: {e}", exc_info=True)
+            # Still signal readiness so the bridge doesn't hang; initialization
+            # will be retried lazily on the first real request
+            await self._notify("ready", {"ok": False, "error": str(e)})
+
     async def run(self):
-        """Main event loop: read from stdin, write to stdout"""
-        logger.info("LightRAG wrapper ready, listening on stdin...")
-        
+        """Main event loop: read from stdin, dispatch each request as a task"""
+        logger.info(
+            f"LightRAG wrapper listening on stdin "
+            f"(max_concurrent_requests={self.max_concurrent_requests})..."
+        )
+
         loop = asyncio.get_event_loop()
-        
+        tasks: set = set()
+
+        # Warm up LightRAG + storage backends now instead of on first call,
+        # and tell the bridge when the backend is actually ready
+        init_task = asyncio.create_task(self._eager_initialize())
+        tasks.add(init_task)
+        init_task.add_done_callback(tasks.discard)
+
+        # Dedicated control-plane task when the bridge passed us fds 3/4
+        control_task = None
+        if os.environ.get("LIGHTRAG_CONTROL_CHANNEL") == "1":
+            control_task = asyncio.create_task(self._run_control_channel())
+
+        # Health monitor reconnects external backends with backoff
+        monitor_task = None
+        if self.neo4j_uri or self.milvus_address:
+            monitor_task = asyncio.create_task(self._monitor_backends())
+
         while True:
             try:
-                # Read line from stdin
-                line = await loop.run_in_executor(None, sys.stdin.readline)
-                
-                if not line:
-                    logger.info("EOF received, shutting down")
-                    break
-                
+                # Read the next message from stdin (framed or line-delimited)
+                if self._use_binary_framing:
+                    line = await loop.run_in_executor(None, self._read_frame_sync)
+                    if line is None:
+                        logger.info("EOF received, shutting down")
+                        break
+                else:
+                    line = await loop.run_in_executor(None, sys.stdin.readline)
+                    if not line:
+                        logger.info("EOF received, shutting down")
+                        break
+
                 line = line.strip()
                 if not line:
                     continue
-                
+
                 # Parse JSON-RPC request
                 request = json.loads(line)
-                
-                # Handle request
-                response = await self.handle_request(request)
-                
-                # Write response to stdout
-                sys.stdout.write(json.dumps(response) + "\n")
-                sys.stdout.flush()
-                
+
+                # Dispatch concurrently; responses are matched by id on the
+                # bridge side, so out-of-order completion is fine
+                task = asyncio.create_task(self._dispatch_request(request))
+                tasks.add(task)
+                task.add_done_callback(tasks.discard)
+
             except json.JSONDecodeError as e:
                 logger.error(f"Invalid JSON: {e}")
                 error_response = {
@@ -414,12 +2450,23 @@ class LightRAGWrapper:
                         "data": str(e)
                     }
                 }
-                sys.stdout.write(json.dumps(error_response) + "\n")
-                sys.stdout.flush()
-                
+                await self._write_response(error_response)
+
             except Exception as e:
                 logger.error(f"Unexpected error: {e}", exc_info=True)
 
+        # Let in-flight requests finish before exiting
+        if tasks:
+            logger.info(f"Waiting for {len(tasks)} in-flight request(s)...")
+            await asyncio.gather(*tasks, return_exceptions=True)
+
+        if control_task is not None:
+            control_task.cancel()
+        if monitor_task is not None:
+            monitor_task.cancel()
+        if self._neo4j_driver is not None:
+            await self._neo4j_driver.close()
+
 
 async def main():
     """Main entry point"""
@@ -434,7 +2481,23 @@ async def main():
         "neo4j_uri": os.environ.get("NEO4J_URI"),
         "neo4j_username": os.environ.get("NEO4J_USERNAME", "neo4j"),
         "neo4j_password": os.environ.get("NEO4J_PASSWORD"),
+        "max_concurrent_requests": int(os.environ.get("LIGHTRAG_MAX_CONCURRENT_REQUESTS", "8")),
+        "insert_batch_size": int(os.environ.get("LIGHTRAG_INSERT_BATCH_SIZE", "32")),
+        "file_read_concurrency": int(os.environ.get("LIGHTRAG_FILE_READ_CONCURRENCY", "16")),
+        "framing": os.environ.get("LIGHTRAG_FRAMING", "ndjson"),
+        "max_warm_workspaces": int(os.environ.get("LIGHTRAG_MAX_WARM_WORKSPACES", "3")),
+        "index_bundle": os.environ.get("LIGHTRAG_INDEX_BUNDLE"),
+        "backend_pool_size": int(os.environ.get("LIGHTRAG_BACKEND_POOL_SIZE", "8")),
+        "backend_warmup": os.environ.get("LIGHTRAG_BACKEND_WARMUP", "1") != "0",
     }
+
+    # Optional workspace map (name -> working_dir) as a JSON object
+    workspaces_env = os.environ.get("LIGHTRAG_WORKSPACES")
+    if workspaces_env:
+        try:
+            config["workspaces"] = json.loads(workspaces_env)
+        except json.JSONDecodeError as e:
+            logger.error(f"Ignoring invalid LIGHTRAG_WORKSPACES: {e}")
     
     wrapper = LightRAGWrapper(**config)
     await wrapper.run()
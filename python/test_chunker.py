@@ -0,0 +1,62 @@
+"""
+Unit tests for the C++ code chunker
+"""
+
+import sys
+from pathlib import Path
+
+# Add parent directory to path
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+from code_chunker import is_cpp_file, chunk_cpp_source
+
+FIXTURE = Path(__file__).parent.parent / "tests" / "fixtures" / "sample-codebase" / "keymanager_sample.cpp"
+
+
+def test_is_cpp_file():
+    """C/C++ extensions are recognized, others are not"""
+    assert is_cpp_file("/src/foo.cpp")
+    assert is_cpp_file("/src/foo.h")
+    assert is_cpp_file("/src/FOO.HPP")
+    assert not is_cpp_file("/src/foo.py")
+    assert not is_cpp_file("/src/Makefile")
+
+
+def test_chunks_carry_metadata_and_cover_file():
+    """Every chunk has a file/line header and all lines are covered in order"""
+    content = FIXTURE.read_text(encoding="utf-8")
+    chunks = chunk_cpp_source(content, str(FIXTURE))
+
+    assert len(chunks) >= 1
+    previous_end = 0
+    for chunk in chunks:
+        assert chunk["text"].startswith(f"// File: {FIXTURE} (lines ")
+        assert chunk["start_line"] == previous_end + 1
+        assert chunk["end_line"] >= chunk["start_line"]
+        previous_end = chunk["end_line"]
+
+    assert previous_end == len(content.split("\n"))
+
+
+def test_small_file_is_single_chunk():
+    """A file under the budget comes back as one chunk"""
+    content = "int add(int a, int b) {\n    return a + b;\n}\n"
+    chunks = chunk_cpp_source(content, "/src/add.cpp")
+
+    assert len(chunks) == 1
+    assert "return a + b;" in chunks[0]["text"]
+
+
+def test_respects_chunk_budget():
+    """Functions are not merged past the size budget"""
+    functions = "\n".join(
+        f"void handler_{i}() {{\n    int value_{i} = {i};\n}}\n" for i in range(50)
+    )
+    chunks = chunk_cpp_source(functions, "/src/handlers.cpp", max_chunk_chars=500)
+
+    assert len(chunks) > 1
+    # No function body is split across chunks
+    for i in range(50):
+        holders = [c for c in chunks if f"handler_{i}()" in c["text"]]
+        assert len(holders) == 1
+        assert f"int value_{i} = {i};" in holders[0]["text"]
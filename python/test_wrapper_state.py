@@ -0,0 +1,531 @@
+"""
+Unit tests for LightRAGWrapper's persisted state: the incremental indexing
+manifest, query/embedding caches, job checkpoints, and index bundles.
+
+The full RAG stack (lightrag, numpy) is not needed for any of this logic,
+so lightweight stand-ins are installed before import and inserts go
+through a fake rag object. Everything here runs with the stdlib only,
+like test_chunker.py.
+"""
+
+import asyncio
+import sys
+import tempfile
+import types
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).parent))
+
+# --- Stand-ins for heavy optional dependencies -----------------------------
+
+
+def _install_stub_modules():
+    try:
+        import lightrag  # noqa: F401
+        return
+    except ImportError:
+        pass
+
+    numpy = types.ModuleType('numpy')
+    numpy.ndarray = list
+    numpy.float32 = float
+    numpy.array = lambda value, dtype=None: value
+    sys.modules.setdefault('numpy', numpy)
+
+    lightrag = types.ModuleType('lightrag')
+
+    class LightRAG:
+        pass
+
+    class QueryParam:
+        def __init__(self, **kwargs):
+            self.__dict__.update(kwargs)
+
+    lightrag.LightRAG = LightRAG
+    lightrag.QueryParam = QueryParam
+
+    llm = types.ModuleType('lightrag.llm')
+    llm_openai = types.ModuleType('lightrag.llm.openai')
+
+    async def openai_complete_if_cache(*args, **kwargs):
+        return ""
+
+    async def openai_embed(*args, **kwargs):
+        return []
+
+    llm_openai.openai_complete_if_cache = openai_complete_if_cache
+    llm_openai.openai_embed = openai_embed
+
+    kg = types.ModuleType('lightrag.kg')
+    shared_storage = types.ModuleType('lightrag.kg.shared_storage')
+
+    async def initialize_pipeline_status():
+        pass
+
+    shared_storage.initialize_pipeline_status = initialize_pipeline_status
+
+    utils = types.ModuleType('lightrag.utils')
+    utils.setup_logger = lambda *args, **kwargs: None
+
+    sys.modules['lightrag'] = lightrag
+    sys.modules['lightrag.llm'] = llm
+    sys.modules['lightrag.llm.openai'] = llm_openai
+    sys.modules['lightrag.kg'] = kg
+    sys.modules['lightrag.kg.shared_storage'] = shared_storage
+    sys.modules['lightrag.utils'] = utils
+
+
+_install_stub_modules()
+
+from lightrag_wrapper import LightRAGWrapper  # noqa: E402
+
+
+# --- Helpers ---------------------------------------------------------------
+
+
+class FakeRAG:
+    """Records ainsert calls; optionally fails them to simulate a dead batch"""
+
+    def __init__(self, fail=False):
+        self.inserted = []
+        self.fail = fail
+
+    async def ainsert(self, docs, file_paths=None):
+        if self.fail:
+            raise RuntimeError("simulated insert failure")
+        self.inserted.append((list(docs), list(file_paths or [])))
+
+
+def make_wrapper(working_dir, embedding_model='text-embedding-3-large'):
+    return LightRAGWrapper(
+        working_dir=str(working_dir),
+        openai_api_key='test-key',
+        openai_base_url='http://localhost:9/v1',
+        openai_embedding_model=embedding_model,
+    )
+
+
+def make_indexing_wrapper(working_dir):
+    """Wrapper wired to a fake rag so index_files runs without the stack"""
+    wrapper = make_wrapper(working_dir)
+    wrapper._initialized = True
+    wrapper.rag = FakeRAG()
+
+    async def _no_notify(method, params):
+        pass
+
+    wrapper._notify = _no_notify
+    return wrapper
+
+
+def write_sources(directory, names_to_contents):
+    paths = []
+    for name, content in names_to_contents.items():
+        path = Path(directory) / name
+        path.write_text(content, encoding='utf-8')
+        paths.append(str(path))
+    return paths
+
+
+# --- Manifest-based skip/new/updated counting ------------------------------
+
+
+def test_first_index_counts_all_files_as_new():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {
+            'a.cpp': 'void a() {}\n',
+            'b.py': 'def b():\n    pass\n',
+        })
+        wrapper = make_indexing_wrapper(Path(tmp) / 'storage')
+
+        result = asyncio.run(wrapper.index_files(sources))
+
+        assert result['success_count'] == 2
+        assert result['new_count'] == 2
+        assert result['updated_count'] == 0
+        assert result['skipped_count'] == 0
+        assert result['error_count'] == 0
+        assert len(wrapper._manifest) == 2
+
+
+def test_unchanged_files_are_skipped_on_rerun():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {'a.cpp': 'void a() {}\n'})
+        wrapper = make_indexing_wrapper(Path(tmp) / 'storage')
+
+        asyncio.run(wrapper.index_files(sources))
+        result = asyncio.run(wrapper.index_files(sources))
+
+        assert result['skipped_count'] == 1
+        assert result['success_count'] == 0
+        assert result['new_count'] == 0
+        assert result['updated_count'] == 0
+
+
+def test_changed_file_is_reindexed_as_updated():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {
+            'a.cpp': 'void a() {}\n',
+            'b.cpp': 'void b() {}\n',
+        })
+        wrapper = make_indexing_wrapper(Path(tmp) / 'storage')
+        asyncio.run(wrapper.index_files(sources))
+
+        Path(sources[0]).write_text('void a() { /* changed */ }\n',
+                                    encoding='utf-8')
+        result = asyncio.run(wrapper.index_files(sources))
+
+        assert result['updated_count'] == 1
+        assert result['skipped_count'] == 1
+        assert result['new_count'] == 0
+        assert result['success_count'] == 1
+
+
+def test_manifest_survives_a_restart():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {'a.cpp': 'void a() {}\n'})
+        storage = Path(tmp) / 'storage'
+        asyncio.run(make_indexing_wrapper(storage).index_files(sources))
+
+        # A fresh process over the same working directory skips the file
+        wrapper = make_indexing_wrapper(storage)
+        result = asyncio.run(wrapper.index_files(sources))
+
+        assert result['skipped_count'] == 1
+        assert result['success_count'] == 0
+
+
+def test_failed_batch_counts_every_file():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {
+            'a.cpp': 'void a() {}\n',
+            'b.cpp': 'void b() {}\n',
+        })
+        wrapper = make_indexing_wrapper(Path(tmp) / 'storage')
+        wrapper.rag = FakeRAG(fail=True)
+
+        result = asyncio.run(wrapper.index_files(sources))
+
+        assert result['error_count'] == 2
+        assert result['success_count'] == 0
+        # Failed files are not recorded as indexed
+        assert len(wrapper._manifest) == 0
+
+
+# --- Query cache generation invalidation -----------------------------------
+
+
+def test_query_cache_round_trips_across_restart():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_wrapper(tmp)
+        wrapper._store_query_result('key-1', {'answer': 'cached answer'})
+
+        reloaded = make_wrapper(tmp)
+        entry = reloaded._query_cache['entries']['key-1']
+        assert entry['result']['answer'] == 'cached answer'
+
+
+def test_generation_bump_drops_cached_entries():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_wrapper(tmp)
+        wrapper._store_query_result('key-1', {'answer': 'stale'})
+
+        wrapper._bump_index_generation()
+
+        assert wrapper._query_cache['generation'] == 1
+        assert wrapper._query_cache['entries'] == {}
+        # The invalidation is durable, not just in-memory
+        assert make_wrapper(tmp)._query_cache['entries'] == {}
+
+
+def test_sibling_process_adopts_bumped_generation():
+    with tempfile.TemporaryDirectory() as tmp:
+        writer = make_wrapper(tmp)
+        reader = make_wrapper(tmp)
+        reader._query_cache['entries']['key-1'] = {
+            'result': {'answer': 'stale'}, 'created_at': 0}
+
+        # The writer process invalidates; the reader still holds its
+        # in-memory copy until the mtime check notices the new file
+        writer._bump_index_generation()
+        reader._refresh_query_cache()
+
+        assert reader._query_cache['generation'] == 1
+        assert 'key-1' not in reader._query_cache['entries']
+
+
+def test_refresh_without_disk_change_keeps_local_entries():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_wrapper(tmp)
+        wrapper._store_query_result('key-1', {'answer': 'fresh'})
+
+        wrapper._refresh_query_cache()
+
+        assert 'key-1' in wrapper._query_cache['entries']
+
+
+def test_store_after_sibling_bump_does_not_resurrect_old_generation():
+    with tempfile.TemporaryDirectory() as tmp:
+        reader = make_wrapper(tmp)
+        writer = make_wrapper(tmp)
+        writer._bump_index_generation()
+
+        # The reader saves a result computed after the bump; the save must
+        # land on the writer's generation, not clobber it with generation 0
+        reader._store_query_result('key-1', {'answer': 'current'})
+
+        assert reader._query_cache['generation'] == 1
+        assert make_wrapper(tmp)._query_cache['generation'] == 1
+
+
+# --- Embedding cache model stamping ----------------------------------------
+
+
+def test_embedding_cache_round_trips_for_same_model():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_wrapper(tmp)
+        wrapper._append_embedding_cache({'hash-1': [0.25, 0.5]})
+
+        reloaded = make_wrapper(tmp)
+        assert reloaded._embedding_cache == {'hash-1': [0.25, 0.5]}
+
+
+def test_embedding_cache_discards_other_models_vectors():
+    with tempfile.TemporaryDirectory() as tmp:
+        old = make_wrapper(tmp, embedding_model='text-embedding-3-large')
+        old._append_embedding_cache({'hash-1': [0.25, 0.5]})
+
+        switched = make_wrapper(tmp, embedding_model='text-embedding-3-small')
+        assert switched._embedding_cache == {}
+
+        # The mismatched entries were compacted away, not merely ignored:
+        # switching back does not resurrect the old model's vectors
+        back = make_wrapper(tmp, embedding_model='text-embedding-3-large')
+        assert back._embedding_cache == {}
+
+
+def test_embedding_cache_discards_unstamped_legacy_entries():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_wrapper(tmp)
+        with open(wrapper._embedding_cache_path, 'a', encoding='utf-8') as f:
+            f.write('{"hash": "legacy", "vector": [1.0]}\n')
+        wrapper._append_embedding_cache({'hash-1': [0.25]})
+
+        reloaded = make_wrapper(tmp)
+        assert reloaded._embedding_cache == {'hash-1': [0.25]}
+
+
+def test_embedding_cache_last_write_wins_per_hash():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_wrapper(tmp)
+        wrapper._append_embedding_cache({'hash-1': [0.1]})
+        wrapper._append_embedding_cache({'hash-1': [0.2]})
+
+        reloaded = make_wrapper(tmp)
+        assert reloaded._embedding_cache == {'hash-1': [0.2]}
+
+
+# --- Job checkpointing and resume ------------------------------------------
+
+
+def run_job_to_completion(wrapper, paths):
+    """Start a background job and wait for its driver task to finish"""
+    async def run():
+        started = await wrapper.start_index_job(paths)
+        job_id = started['job_id']
+        task = wrapper._job_tasks.get(job_id)
+        if task is not None:
+            await task
+        return job_id, await wrapper.get_job_status(job_id)
+    return asyncio.run(run())
+
+
+def test_background_job_runs_to_completion():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {
+            'a.cpp': 'void a() {}\n',
+            'b.cpp': 'void b() {}\n',
+        })
+        wrapper = make_indexing_wrapper(Path(tmp) / 'storage')
+
+        job_id, status = run_job_to_completion(wrapper, sources)
+
+        assert status['status'] == 'completed'
+        assert status['processed'] == 2
+        assert status['success_count'] == 2
+        assert status['error_count'] == 0
+        assert status['finished_at'] is not None
+        # The public view hides checkpoint internals
+        assert 'file_paths' not in status
+        assert 'cancel_requested' not in status
+
+
+def test_running_job_loads_as_interrupted_with_its_file_list():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {'a.cpp': 'void a() {}\n'})
+        storage = Path(tmp) / 'storage'
+        wrapper = make_indexing_wrapper(storage)
+        job_id, _ = run_job_to_completion(wrapper, sources)
+
+        # Simulate a process that died mid-job: the checkpoint on disk
+        # still says running
+        wrapper._jobs[job_id]['status'] = 'running'
+        wrapper._save_jobs()
+
+        restarted = make_indexing_wrapper(storage)
+        job = restarted._jobs[job_id]
+        assert job['status'] == 'interrupted'
+        # The file list comes back from its own once-per-job checkpoint
+        assert job['file_paths'] == sources
+
+
+def test_resume_skips_batches_already_in_the_manifest():
+    with tempfile.TemporaryDirectory() as tmp:
+        sources = write_sources(tmp, {
+            'a.cpp': 'void a() {}\n',
+            'b.cpp': 'void b() {}\n',
+        })
+        storage = Path(tmp) / 'storage'
+        wrapper = make_indexing_wrapper(storage)
+        job_id, _ = run_job_to_completion(wrapper, sources)
+        wrapper._jobs[job_id]['status'] = 'running'
+        wrapper._save_jobs()
+
+        restarted = make_indexing_wrapper(storage)
+
+        async def resume():
+            result = await restarted.resume_index_job(job_id)
+            task = restarted._job_tasks.get(job_id)
+            if task is not None:
+                await task
+            return result, await restarted.get_job_status(job_id)
+
+        resumed, status = asyncio.run(resume())
+
+        assert resumed['resumed'] is True
+        assert status['status'] == 'completed'
+        assert status['skipped_count'] == 2
+        # Nothing was re-inserted; the manifest answered for every file
+        assert restarted.rag.inserted == []
+
+
+def test_resume_of_unknown_job_is_an_error():
+    with tempfile.TemporaryDirectory() as tmp:
+        wrapper = make_indexing_wrapper(tmp)
+        try:
+            asyncio.run(wrapper.resume_index_job('no-such-job'))
+            raise AssertionError('expected ValueError')
+        except ValueError as e:
+            assert 'Unknown job' in str(e)
+
+
+# --- Index bundle export / import ------------------------------------------
+
+
+def export_indexed_bundle(tmp):
+    """Index two files and export the working directory as a bundle"""
+    sources = write_sources(tmp, {
+        'a.cpp': 'void a() {}\n',
+        'b.cpp': 'void b() {}\n',
+    })
+    wrapper = make_indexing_wrapper(Path(tmp) / 'source-storage')
+    asyncio.run(wrapper.index_files(sources))
+
+    bundle_path = str(Path(tmp) / 'index.tar.gz')
+    result = asyncio.run(wrapper.export_index_bundle(bundle_path))
+    return wrapper, bundle_path, result
+
+
+def test_bundle_export_import_round_trip():
+    with tempfile.TemporaryDirectory() as tmp:
+        exporter, bundle_path, exported = export_indexed_bundle(tmp)
+        assert exported['documents'] == 2
+        assert Path(bundle_path).exists()
+
+        importer = make_wrapper(Path(tmp) / 'restored-storage')
+        result = asyncio.run(importer.import_index_bundle(bundle_path))
+
+        assert result['imported'] is True
+        assert result['manifest_entries'] == len(exporter._manifest)
+        assert importer._manifest == exporter._manifest
+        assert importer._stats == exporter._stats
+        # The restored directory answers skip checks like the original:
+        # nothing needs reindexing
+        importer._initialized = True
+        importer.rag = FakeRAG()
+        rerun = asyncio.run(importer.index_files(
+            sorted(exporter._manifest.keys())))
+        assert rerun['skipped_count'] == 2
+
+
+def test_import_refuses_to_overwrite_without_force():
+    with tempfile.TemporaryDirectory() as tmp:
+        _, bundle_path, _ = export_indexed_bundle(tmp)
+
+        occupied = make_indexing_wrapper(Path(tmp) / 'occupied-storage')
+        sources = write_sources(tmp, {'c.cpp': 'void c() {}\n'})
+        asyncio.run(occupied.index_files(sources))
+
+        try:
+            asyncio.run(occupied.import_index_bundle(bundle_path))
+            raise AssertionError('expected ValueError')
+        except ValueError as e:
+            assert 'force' in str(e)
+
+        result = asyncio.run(
+            occupied.import_index_bundle(bundle_path, force=True))
+        assert result['imported'] is True
+
+
+def test_import_rejects_a_plain_tarball():
+    import tarfile
+
+    with tempfile.TemporaryDirectory() as tmp:
+        payload = Path(tmp) / 'random.txt'
+        payload.write_text('not a bundle\n', encoding='utf-8')
+        tarball = Path(tmp) / 'plain.tar.gz'
+        with tarfile.open(tarball, 'w:gz') as tar:
+            tar.add(payload, arcname='random.txt')
+
+        wrapper = make_wrapper(Path(tmp) / 'storage')
+        try:
+            asyncio.run(wrapper.import_index_bundle(str(tarball)))
+            raise AssertionError('expected ValueError')
+        except ValueError as e:
+            assert 'bundle_manifest.json' in str(e)
+
+
+def test_import_never_extracts_escaping_members():
+    import io
+    import json
+    import tarfile
+
+    with tempfile.TemporaryDirectory() as tmp:
+        bundle = Path(tmp) / 'crafted.tar.gz'
+        with tarfile.open(bundle, 'w:gz') as tar:
+            meta = json.dumps({'bundle_format': 1}).encode('utf-8')
+            info = tarfile.TarInfo('bundle_manifest.json')
+            info.size = len(meta)
+            tar.addfile(info, io.BytesIO(meta))
+
+            evil = b'escaped\n'
+            info = tarfile.TarInfo('../escape.txt')
+            info.size = len(evil)
+            tar.addfile(info, io.BytesIO(evil))
+
+            link = tarfile.TarInfo('link-out')
+            link.type = tarfile.SYMTYPE
+            link.linkname = '/etc/passwd'
+            tar.addfile(link)
+
+        storage = Path(tmp) / 'storage'
+        wrapper = make_wrapper(storage)
+        try:
+            asyncio.run(wrapper.import_index_bundle(str(bundle)))
+        except Exception:
+            # The data extraction filter may refuse the symlink outright;
+            # either way nothing unsafe must land on disk
+            pass
+
+        assert not (Path(tmp) / 'escape.txt').exists()
+        assert not (storage / 'link-out').exists()
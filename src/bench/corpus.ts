@@ -0,0 +1,79 @@
+import * as fs from 'fs';
+import * as path from 'path';
+import { fileURLToPath } from 'url';
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = path.dirname(__filename);
+
+const FIXTURE_DIR = path.join(__dirname, '..', '..', 'tests', 'fixtures', 'sample-codebase');
+
+export interface CorpusOptions {
+  /** Number of .cpp/.h file pairs to generate */
+  files: number;
+  /** Number of iterator classes expanded into each file pair */
+  entitiesPerFile: number;
+}
+
+export interface CorpusResult {
+  filePaths: string[];
+  totalEntities: number;
+  totalBytes: number;
+}
+
+/**
+ * Generates a synthetic C++ corpus by parameterized expansion of the
+ * keymanager_sample fixture pair.
+ *
+ * Each generated file pair is the fixture with its class renamed to a
+ * unique `keymanager_module<i>_op<j>` per entity, so the corpus scales in
+ * both file count and entities-per-file while staying representative of
+ * the ONTAP SMF iterator code the chunker and extraction prompts were
+ * tuned against. Generation is deterministic: the same (files, entities)
+ * parameters always produce byte-identical output, so runs are comparable
+ * release over release.
+ */
+export function generateCorpus(outputDir: string, options: CorpusOptions): CorpusResult {
+  const headerTemplate = fs.readFileSync(path.join(FIXTURE_DIR, 'keymanager_sample.h'), 'utf-8');
+  const sourceTemplate = fs.readFileSync(path.join(FIXTURE_DIR, 'keymanager_sample.cpp'), 'utf-8');
+
+  fs.mkdirSync(outputDir, { recursive: true });
+
+  const filePaths: string[] = [];
+  let totalBytes = 0;
+
+  for (let i = 0; i < options.files; i++) {
+    const headerParts: string[] = [];
+    const sourceParts: string[] = [];
+
+    for (let j = 0; j < options.entitiesPerFile; j++) {
+      const className = `keymanager_module${i}_op${j}_iterator`;
+      headerParts.push(expand(headerTemplate, className, i, j));
+      sourceParts.push(expand(sourceTemplate, className, i, j));
+    }
+
+    const headerPath = path.join(outputDir, `keymanager_module${i}.h`);
+    const sourcePath = path.join(outputDir, `keymanager_module${i}.cpp`);
+    const headerText = headerParts.join('\n\n');
+    const sourceText = sourceParts.join('\n\n');
+
+    fs.writeFileSync(headerPath, headerText);
+    fs.writeFileSync(sourcePath, sourceText);
+
+    filePaths.push(headerPath, sourcePath);
+    totalBytes += headerText.length + sourceText.length;
+  }
+
+  return {
+    filePaths,
+    totalEntities: options.files * options.entitiesPerFile,
+    totalBytes,
+  };
+}
+
+function expand(template: string, className: string, fileIndex: number, entityIndex: number): string {
+  return template
+    .replace(/keymanager_keystore_enable_iterator/g, className)
+    .replace(/cluster_kdb_rdb_callbackHandler/g, `module${fileIndex}_op${entityIndex}_rdb_callbackHandler`)
+    .replace(/KEYMANAGER_SAMPLE_H/g, `KEYMANAGER_MODULE${fileIndex}_OP${entityIndex}_H`)
+    .replace(/keymanager_sample\.h/g, `keymanager_module${fileIndex}.h`);
+}
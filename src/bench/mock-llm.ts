@@ -0,0 +1,151 @@
+import * as http from 'http';
+import * as crypto from 'crypto';
+
+export interface MockLLMOptions {
+  /** Artificial per-request delay, to approximate real model latency */
+  latencyMs?: number;
+  /** Dimension of the vectors returned by the embeddings endpoint */
+  embeddingDim?: number;
+}
+
+/**
+ * Minimal OpenAI-compatible endpoint for benchmarking.
+ *
+ * Serves /chat/completions and /embeddings with deterministic canned
+ * output so benchmark runs measure the bridge, wrapper, and storage
+ * layers -- not a remote model's mood. Embeddings are seeded from a hash
+ * of the input text, so identical chunks always embed identically and
+ * vector-store behavior (dedup, nearest-neighbor) stays realistic.
+ */
+export class MockLLMServer {
+  private server: http.Server;
+  private readonly latencyMs: number;
+  private readonly embeddingDim: number;
+
+  chatRequests = 0;
+  embeddingRequests = 0;
+
+  constructor(options: MockLLMOptions = {}) {
+    this.latencyMs = options.latencyMs ?? 0;
+    this.embeddingDim = options.embeddingDim ?? 1536;
+    this.server = http.createServer((req, res) => this.handle(req, res));
+  }
+
+  async start(): Promise<number> {
+    return new Promise((resolve, reject) => {
+      this.server.once('error', reject);
+      this.server.listen(0, '127.0.0.1', () => {
+        const address = this.server.address();
+        if (address && typeof address === 'object') {
+          resolve(address.port);
+        } else {
+          reject(new Error('Could not determine mock LLM port'));
+        }
+      });
+    });
+  }
+
+  async stop(): Promise<void> {
+    return new Promise((resolve) => this.server.close(() => resolve()));
+  }
+
+  get baseUrl(): string {
+    const address = this.server.address();
+    const port = address && typeof address === 'object' ? address.port : 0;
+    return `http://127.0.0.1:${port}/v1`;
+  }
+
+  private handle(req: http.IncomingMessage, res: http.ServerResponse): void {
+    const chunks: Buffer[] = [];
+    req.on('data', (chunk) => chunks.push(chunk));
+    req.on('end', () => {
+      let body: any = {};
+      try {
+        body = JSON.parse(Buffer.concat(chunks).toString('utf-8') || '{}');
+      } catch {
+        // Fall through with an empty body; respond with canned output anyway
+      }
+
+      const respond = () => {
+        if (req.url?.endsWith('/embeddings')) {
+          this.handleEmbeddings(body, res);
+        } else if (req.url?.endsWith('/chat/completions')) {
+          this.handleChat(body, res);
+        } else {
+          res.writeHead(404, { 'Content-Type': 'application/json' });
+          res.end(JSON.stringify({ error: { message: `Unknown path: ${req.url}` } }));
+        }
+      };
+
+      if (this.latencyMs > 0) {
+        setTimeout(respond, this.latencyMs);
+      } else {
+        respond();
+      }
+    });
+  }
+
+  private handleChat(body: any, res: http.ServerResponse): void {
+    this.chatRequests++;
+
+    const content =
+      'The retrieved code implements ONTAP SMF iterator classes for key ' +
+      'manager operations: each iterator validates prerequisites, updates ' +
+      'the wrapped key database, synchronizes MetroCluster partners, and ' +
+      'commits or rolls back through RDB callback handlers.';
+
+    res.writeHead(200, { 'Content-Type': 'application/json' });
+    res.end(
+      JSON.stringify({
+        id: 'chatcmpl-bench',
+        object: 'chat.completion',
+        created: Math.floor(Date.now() / 1000),
+        model: body.model || 'mock',
+        choices: [
+          {
+            index: 0,
+            message: { role: 'assistant', content },
+            finish_reason: 'stop',
+          },
+        ],
+        usage: { prompt_tokens: 100, completion_tokens: 60, total_tokens: 160 },
+      })
+    );
+  }
+
+  private handleEmbeddings(body: any, res: http.ServerResponse): void {
+    this.embeddingRequests++;
+
+    const inputs: string[] = Array.isArray(body.input) ? body.input : [body.input ?? ''];
+    const data = inputs.map((text, index) => ({
+      object: 'embedding',
+      index,
+      embedding: this.embed(String(text)),
+    }));
+
+    res.writeHead(200, { 'Content-Type': 'application/json' });
+    res.end(
+      JSON.stringify({
+        object: 'list',
+        data,
+        model: body.model || 'mock',
+        usage: { prompt_tokens: inputs.length * 50, total_tokens: inputs.length * 50 },
+      })
+    );
+  }
+
+  private embed(text: string): number[] {
+    // Hash-seeded pseudo-random unit vector: deterministic per input text
+    const vector: number[] = [];
+    let seed = crypto.createHash('md5').update(text).digest();
+    while (vector.length < this.embeddingDim) {
+      for (let i = 0; i < seed.length && vector.length < this.embeddingDim; i += 2) {
+        vector.push((seed.readUInt16BE(i) / 65535) * 2 - 1);
+      }
+      seed = crypto.createHash('md5').update(seed).digest();
+    }
+
+    const norm = Math.sqrt(vector.reduce((sum, v) => sum + v * v, 0)) || 1;
+    return vector.map((v) => v / norm);
+  }
+}
@@ -0,0 +1,183 @@
+#!/usr/bin/env node
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { LightRAGBridge } from '../lightrag-bridge.js';
+import { generateCorpus } from './corpus.js';
+import { MockLLMServer } from './mock-llm.js';
+
+/**
+ * Benchmark harness: `npm run bench`.
+ *
+ * Generates a synthetic C++ corpus from the keymanager_sample fixtures,
+ * indexes it through the real bridge + wrapper stack against a local mock
+ * LLM endpoint, then measures query latency per search mode. Results are
+ * written as JSON so successive releases can be diffed mechanically.
+ *
+ * Tunables (environment):
+ *   BENCH_FILES          file pairs to generate        (default 20)
+ *   BENCH_ENTITIES       iterator classes per pair     (default 5)
+ *   BENCH_QUERIES        queries per search mode       (default 10)
+ *   BENCH_LLM_LATENCY_MS simulated model latency       (default 50)
+ *   BENCH_OUTPUT         results file                  (default bench-results.json)
+ */
+
+const SEARCH_MODES = ['local', 'global', 'hybrid', 'mix', 'naive'] as const;
+
+const QUERY_TEMPLATES = [
+  'How does module %d validate prerequisites before enabling the keystore?',
+  'What does the rollback path of module %d do?',
+  'Which components does module %d synchronize with MetroCluster?',
+  'Describe the RDB commit phases used by module %d',
+  'How is the wrapped key database updated in module %d?',
+];
+
+interface LatencyStats {
+  count: number;
+  avg_ms: number;
+  p50_ms: number;
+  p95_ms: number;
+  min_ms: number;
+  max_ms: number;
+}
+
+function summarize(samples: number[]): LatencyStats {
+  const ordered = [...samples].sort((a, b) => a - b);
+  const at = (fraction: number) =>
+    ordered[Math.min(ordered.length - 1, Math.floor(fraction * ordered.length))];
+  return {
+    count: samples.length,
+    avg_ms: Math.round(samples.reduce((a, b) => a + b, 0) / samples.length),
+    p50_ms: Math.round(at(0.5)),
+    p95_ms: Math.round(at(0.95)),
+    min_ms: Math.round(ordered[0]),
+    max_ms: Math.round(ordered[ordered.length - 1]),
+  };
+}
+
+function intEnv(name: string, fallback: number): number {
+  const raw = process.env[name];
+  const value = raw ? parseInt(raw, 10) : NaN;
+  return Number.isFinite(value) ? value : fallback;
+}
+
+async function main(): Promise<void> {
+  const params = {
+    files: intEnv('BENCH_FILES', 20),
+    entitiesPerFile: intEnv('BENCH_ENTITIES', 5),
+    queriesPerMode: intEnv('BENCH_QUERIES', 10),
+    llmLatencyMs: intEnv('BENCH_LLM_LATENCY_MS', 50),
+  };
+  const outputPath = process.env.BENCH_OUTPUT || 'bench-results.json';
+
+  const corpusDir = fs.mkdtempSync(path.join(os.tmpdir(), 'lightrag-bench-corpus-'));
+  const workingDir = fs.mkdtempSync(path.join(os.tmpdir(), 'lightrag-bench-storage-'));
+
+  console.error(`Generating corpus: ${params.files} file pairs x ${params.entitiesPerFile} entities`);
+  const corpus = generateCorpus(corpusDir, {
+    files: params.files,
+    entitiesPerFile: params.entitiesPerFile,
+  });
+
+  const mockLLM = new MockLLMServer({ latencyMs: params.llmLatencyMs });
+  await mockLLM.start();
+
+  const bridge = new LightRAGBridge({
+    workingDir,
+    openaiApiKey: 'bench-key',
+    openaiBaseUrl: mockLLM.baseUrl,
+    openaiModel: 'gpt-4',
+    openaiEmbeddingModel: 'text-embedding-ada-002',
+    timeout: 600000,
+    autoRestart: false,
+  });
+
+  // Without a listener an 'error' emit from the bridge crashes the run
+  // with ERR_UNHANDLED_ERROR; log it and let in-flight calls surface it
+  bridge.on('error', (error: Error) => {
+    console.error('Bridge error:', error.message);
+  });
+
+  try {
+    await bridge.start();
+
+    // --- Indexing throughput ---
+    console.error(`Indexing ${corpus.filePaths.length} files...`);
+    const indexStart = Date.now();
+    const indexResult = await bridge.call(
+      'index_files',
+      { file_paths: corpus.filePaths },
+      { timeout: 600000 }
+    );
+    const indexSeconds = (Date.now() - indexStart) / 1000;
+
+    const status = await bridge.call('get_indexing_status', {});
+    const chunks = status.index_stats?.chunks ?? 0;
+
+    const indexing = {
+      files: corpus.filePaths.length,
+      entities_generated: corpus.totalEntities,
+      corpus_bytes: corpus.totalBytes,
+      indexed: indexResult.success_count,
+      errors: indexResult.error_count ?? (indexResult.errors?.length || 0),
+      chunks,
+      elapsed_seconds: Math.round(indexSeconds * 100) / 100,
+      files_per_second: Math.round((corpus.filePaths.length / indexSeconds) * 100) / 100,
+      chunks_per_second: Math.round((chunks / indexSeconds) * 100) / 100,
+    };
+    console.error(
+      `Indexed in ${indexing.elapsed_seconds}s ` +
+        `(${indexing.files_per_second} files/s, ${indexing.chunks_per_second} chunks/s)`
+    );
+
+    // --- Query latency per mode ---
+    const queries: Record<string, LatencyStats> = {};
+    for (const mode of SEARCH_MODES) {
+      const samples: number[] = [];
+      for (let i = 0; i < params.queriesPerMode; i++) {
+        // Vary the module index so the query cache and search coalescing
+        // don't turn the run into a cache benchmark
+        const template = QUERY_TEMPLATES[i % QUERY_TEMPLATES.length];
+        const query = template.replace('%d', String(i % params.files));
+
+        const start = Date.now();
+        await bridge.call('search_code', { query, mode, top_k: 10 }, { timeout: 600000 });
+        samples.push(Date.now() - start);
+      }
+      queries[mode] = summarize(samples);
+      console.error(
+        `${mode}: p50 ${queries[mode].p50_ms}ms, p95 ${queries[mode].p95_ms}ms ` +
+          `over ${samples.length} queries`
+      );
+    }
+
+    const results = {
+      benchmark_version: 1,
+      timestamp: new Date().toISOString(),
+      params,
+      indexing,
+      queries,
+      mock_llm: {
+        chat_requests: mockLLM.chatRequests,
+        embedding_requests: mockLLM.embeddingRequests,
+        latency_ms: params.llmLatencyMs,
+      },
+      bridge_metrics: bridge.getMetrics(),
+    };
+
+    fs.writeFileSync(outputPath, JSON.stringify(results, null, 2) + '\n');
+    console.error(`Results written to ${outputPath}`);
+    // stdout carries only the machine-readable payload, for piping into jq
+    console.log(JSON.stringify(results));
+  } finally {
+    await bridge.stop();
+    await mockLLM.stop();
+    fs.rmSync(corpusDir, { recursive: true, force: true });
+    fs.rmSync(workingDir, { recursive: true, force: true });
+  }
+}
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,124 @@
+import { EventEmitter } from 'events';
+import { LightRAGBridge, BridgeConfig } from './lightrag-bridge.js';
+
+export interface BridgePoolConfig extends BridgeConfig {
+  poolSize?: number;
+}
+
+/**
+ * Methods that mutate the index, plus the whole background-job lifecycle.
+ * These are serialized through a single designated writer worker so
+ * concurrent wrapper processes never race on the shared working directory
+ * / storage backends. Job status and cancel calls must land on the same
+ * process that owns the running job — each wrapper only knows about jobs
+ * it started or loaded at startup.
+ */
+const WRITE_METHODS = new Set([
+  'index_files',
+  'insert_text',
+  'insert_texts',
+  'export_index_bundle',
+  'import_index_bundle',
+  'start_index_job',
+  'resume_index_job',
+  'get_job_status',
+  'cancel_job',
+]);
+
+/**
+ * Pool of LightRAG wrapper processes sharing one working directory.
+ *
+ * Worker 0 is the designated writer; read-only calls (search_code,
+ * get_entity, get_relationships, ...) are routed to the worker with the
+ * fewest in-flight requests so they can run in parallel across Python
+ * processes instead of serializing through one GIL and one stdio pipe.
+ */
+export class LightRAGBridgePool extends EventEmitter {
+  private workers: LightRAGBridge[] = [];
+  private readonly poolSize: number;
+
+  constructor(private config: BridgePoolConfig) {
+    super();
+
+    this.poolSize = Math.max(1, config.poolSize || 1);
+
+    for (let i = 0; i < this.poolSize; i++) {
+      const worker = new LightRAGBridge(config);
+
+      // Re-emit worker events tagged with the worker index so callers can
+      // keep their existing listeners
+      worker.on('error', (error) => this.emit('error', error, i));
+      worker.on('log', (line) => this.emit('log', line, i));
+      worker.on('exit', (info) => this.emit('exit', info, i));
+      worker.on('restarting', (count) => this.emit('restarting', count, i));
+      worker.on('healthCheckFailed', (error) => this.emit('healthCheckFailed', error, i));
+      worker.on('notification', (method, params) => this.emit('notification', method, params, i));
+
+      this.workers.push(worker);
+    }
+  }
+
+  async start(): Promise<void> {
+    await Promise.all(this.workers.map((worker) => worker.start()));
+    this.emit('started');
+  }
+
+  async stop(): Promise<void> {
+    await Promise.all(this.workers.map((worker) => worker.stop()));
+    this.emit('stopped');
+  }
+
+  async call(
+    method: string,
+    params: Record<string, any> = {},
+    options?: { timeout?: number; onChunk?: (chunk: string) => void }
+  ): Promise<any> {
+    return this.routeWorker(method).call(method, params, options);
+  }
+
+  private routeWorker(method: string): LightRAGBridge {
+    // Writes always go through worker 0 so index mutations stay ordered
+    if (WRITE_METHODS.has(method)) {
+      return this.workers[0];
+    }
+
+    // Reads go to the least-loaded running worker (the writer included --
+    // when idle it serves reads like everyone else)
+    let best = this.workers[0];
+    for (const worker of this.workers) {
+      if (!worker.isRunning()) {
+        continue;
+      }
+      if (!best.isRunning() || worker.pendingCount < best.pendingCount) {
+        best = worker;
+      }
+    }
+    return best;
+  }
+
+  isRunning(): boolean {
+    return this.workers.some((worker) => worker.isRunning());
+  }
+
+  /** Transport-side latency metrics for every worker, indexed by position. */
+  getMetrics(): Array<Record<string, any>> {
+    return this.workers.map((worker) => worker.getMetrics());
+  }
+
+  /** Call every running worker with the same request (used for metrics collection). */
+  async callAll(
+    method: string,
+    params: Record<string, any> = {},
+    options?: { timeout?: number }
+  ): Promise<any[]> {
+    return Promise.all(
+      this.workers
+        .filter((worker) => worker.isRunning())
+        .map((worker) => worker.call(method, params, options))
+    );
+  }
+
+  get size(): number {
+    return this.poolSize;
+  }
+}
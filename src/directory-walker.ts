@@ -0,0 +1,222 @@
+import * as fs from 'fs';
+import * as path from 'path';
+
+export interface WalkOptions {
+  include?: string[];
+  exclude?: string[];
+  respectGitignore?: boolean;
+  batchSize?: number;
+  maxFiles?: number;
+}
+
+interface GitignoreRule {
+  regex: RegExp;
+  dirOnly: boolean;
+  negated: boolean;
+}
+
+interface GitignoreScope {
+  baseDir: string;
+  rules: GitignoreRule[];
+}
+
+// Directories that are never worth indexing, gitignore or not
+export const DEFAULT_EXCLUDED_DIRS = new Set([
+  '.git', 'node_modules', 'dist', 'build', '__pycache__', '.venv', 'venv',
+]);
+
+/**
+ * Translate a glob pattern (gitignore-style subset: `*`, `**`, `?`) into a
+ * regular expression over a slash-separated relative path.
+ */
+export function globToRegExp(pattern: string, matchBase: boolean): RegExp {
+  let regex = '';
+  for (let i = 0; i < pattern.length; i++) {
+    const char = pattern[i];
+    if (char === '*') {
+      if (pattern[i + 1] === '*') {
+        // `**` crosses directory boundaries
+        regex += '.*';
+        i++;
+        if (pattern[i + 1] === '/') i++;
+      } else {
+        regex += '[^/]*';
+      }
+    } else if (char === '?') {
+      regex += '[^/]';
+    } else if ('\\^$.|+()[]{}'.includes(char)) {
+      regex += '\\' + char;
+    } else {
+      regex += char;
+    }
+  }
+  // Unanchored patterns may match at any depth
+  const prefix = matchBase ? '(^|.*/)' : '^';
+  return new RegExp(`${prefix}${regex}$`);
+}
+
+function parseGitignore(content: string, baseDir: string): GitignoreScope {
+  const rules: GitignoreRule[] = [];
+
+  for (let line of content.split('\n')) {
+    line = line.replace(/\r$/, '');
+    if (!line.trim() || line.startsWith('#')) {
+      continue;
+    }
+
+    let negated = false;
+    if (line.startsWith('!')) {
+      negated = true;
+      line = line.slice(1);
+    }
+
+    let dirOnly = false;
+    if (line.endsWith('/')) {
+      dirOnly = true;
+      line = line.slice(0, -1);
+    }
+
+    // A pattern containing a slash is anchored to the gitignore's directory
+    const anchored = line.startsWith('/') || line.slice(0, -1).includes('/');
+    if (line.startsWith('/')) {
+      line = line.slice(1);
+    }
+
+    try {
+      rules.push({ regex: globToRegExp(line, !anchored), dirOnly, negated });
+    } catch {
+      // Skip unparseable patterns rather than failing the walk
+    }
+  }
+
+  return { baseDir, rules };
+}
+
+function isIgnored(
+  absolutePath: string,
+  isDirectory: boolean,
+  scopes: GitignoreScope[]
+): boolean {
+  let ignored = false;
+
+  // Later (deeper) scopes and later rules win, matching gitignore semantics
+  for (const scope of scopes) {
+    const relative = path.relative(scope.baseDir, absolutePath).split(path.sep).join('/');
+    for (const rule of scope.rules) {
+      if (rule.dirOnly && !isDirectory) {
+        continue;
+      }
+      if (rule.regex.test(relative)) {
+        ignored = !rule.negated;
+      }
+    }
+  }
+
+  return ignored;
+}
+
+/**
+ * Walk a directory tree and yield batches of matching file paths.
+ *
+ * Directories at each level are read in parallel; batches are yielded as
+ * soon as they fill so the caller can overlap ingestion with the walk.
+ * Include/exclude globs apply to paths relative to the root; .gitignore
+ * files are honored per directory when respectGitignore is set (default).
+ */
+export async function* walkDirectoryBatches(
+  root: string,
+  options: WalkOptions = {}
+): AsyncGenerator<string[]> {
+  const batchSize = options.batchSize ?? 200;
+  const maxFiles = options.maxFiles ?? Infinity;
+  const respectGitignore = options.respectGitignore !== false;
+
+  const includes = (options.include || []).map((p) => globToRegExp(p, !p.includes('/')));
+  const excludes = (options.exclude || []).map((p) => globToRegExp(p, !p.includes('/')));
+
+  const rootAbs = path.resolve(root);
+  let level: Array<{ dir: string; scopes: GitignoreScope[] }> = [
+    { dir: rootAbs, scopes: [] },
+  ];
+
+  let pending: string[] = [];
+  let emitted = 0;
+
+  while (level.length > 0 && emitted + pending.length < maxFiles) {
+    const results = await Promise.all(
+      level.map(async ({ dir, scopes }) => {
+        let entries: fs.Dirent[];
+        try {
+          entries = await fs.promises.readdir(dir, { withFileTypes: true });
+        } catch {
+          return { dir, scopes, entries: [] as fs.Dirent[] };
+        }
+
+        let dirScopes = scopes;
+        if (respectGitignore && entries.some((e) => e.name === '.gitignore' && e.isFile())) {
+          try {
+            const content = await fs.promises.readFile(path.join(dir, '.gitignore'), 'utf-8');
+            dirScopes = [...scopes, parseGitignore(content, dir)];
+          } catch {
+            // Unreadable .gitignore: walk without it
+          }
+        }
+
+        return { dir, scopes: dirScopes, entries };
+      })
+    );
+
+    const nextLevel: Array<{ dir: string; scopes: GitignoreScope[] }> = [];
+
+    for (const { dir, scopes, entries } of results) {
+      if (emitted + pending.length >= maxFiles) {
+        break;
+      }
+      for (const entry of entries) {
+        const absolute = path.join(dir, entry.name);
+        const relative = path.relative(rootAbs, absolute).split(path.sep).join('/');
+
+        if (entry.isDirectory()) {
+          if (DEFAULT_EXCLUDED_DIRS.has(entry.name)) {
+            continue;
+          }
+          if (excludes.some((regex) => regex.test(relative))) {
+            continue;
+          }
+          if (respectGitignore && isIgnored(absolute, true, scopes)) {
+            continue;
+          }
+          nextLevel.push({ dir: absolute, scopes });
+        } else if (entry.isFile()) {
+          if (includes.length > 0 && !includes.some((regex) => regex.test(relative))) {
+            continue;
+          }
+          if (excludes.some((regex) => regex.test(relative))) {
+            continue;
+          }
+          if (respectGitignore && isIgnored(absolute, false, scopes)) {
+            continue;
+          }
+
+          if (emitted + pending.length >= maxFiles) {
+            break;
+          }
+          pending.push(absolute);
+        }
+      }
+
+      while (pending.length >= batchSize) {
+        const batch = pending.splice(0, batchSize);
+        emitted += batch.length;
+        yield batch;
+      }
+    }
+
+    level = nextLevel;
+  }
+
+  if (pending.length > 0) {
+    emitted += pending.length;
+    yield pending;
+  }
+}
@@ -0,0 +1,199 @@
+import * as fs from 'fs';
+import * as path from 'path';
+import { EventEmitter } from 'events';
+import { globToRegExp, DEFAULT_EXCLUDED_DIRS } from './directory-walker.js';
+
+export interface WatcherOptions {
+  include?: string[];
+  exclude?: string[];
+  /** Quiet period after the last change before a batch is emitted */
+  debounceMs?: number;
+  /** Upper bound on how long changes can sit before a batch is forced out */
+  maxBatchDelayMs?: number;
+}
+
+/**
+ * Watches a directory tree and emits debounced batches of changed files.
+ *
+ * Each directory gets its own fs.watch handle (portable, unlike recursive
+ * watching); new subdirectories are picked up as they appear. Rapid editor
+ * churn (save, format-on-save, build artifacts) collapses into one batch
+ * per quiet period, bounded by maxBatchDelayMs so a steady stream of edits
+ * still flushes regularly.
+ *
+ * Emits: 'batch' (string[] of absolute file paths), 'error'.
+ */
+export class DirectoryWatcher extends EventEmitter {
+  private readonly rootAbs: string;
+  private readonly includes: RegExp[];
+  private readonly excludes: RegExp[];
+  private readonly debounceMs: number;
+  private readonly maxBatchDelayMs: number;
+
+  private watchers = new Map<string, fs.FSWatcher>();
+  private pendingFiles = new Set<string>();
+  private debounceTimer: NodeJS.Timeout | null = null;
+  private firstChangeAt = 0;
+  private closed = false;
+
+  constructor(root: string, options: WatcherOptions = {}) {
+    super();
+
+    this.rootAbs = path.resolve(root);
+    this.includes = (options.include || []).map((p) => globToRegExp(p, !p.includes('/')));
+    this.excludes = (options.exclude || []).map((p) => globToRegExp(p, !p.includes('/')));
+    this.debounceMs = options.debounceMs ?? 500;
+    this.maxBatchDelayMs = options.maxBatchDelayMs ?? 5000;
+  }
+
+  async start(): Promise<void> {
+    await this.watchTree(this.rootAbs);
+  }
+
+  private async watchTree(dir: string): Promise<void> {
+    if (this.closed) {
+      return;
+    }
+
+    this.watchDir(dir);
+
+    let entries: fs.Dirent[];
+    try {
+      entries = await fs.promises.readdir(dir, { withFileTypes: true });
+    } catch {
+      return;
+    }
+
+    for (const entry of entries) {
+      if (!entry.isDirectory() || DEFAULT_EXCLUDED_DIRS.has(entry.name)) {
+        continue;
+      }
+      const absolute = path.join(dir, entry.name);
+      if (this.isExcluded(absolute)) {
+        continue;
+      }
+      await this.watchTree(absolute);
+    }
+  }
+
+  private watchDir(dir: string): void {
+    if (this.watchers.has(dir)) {
+      return;
+    }
+
+    try {
+      const watcher = fs.watch(dir, (_eventType, filename) => {
+        if (filename) {
+          this.onEvent(dir, String(filename));
+        }
+      });
+
+      // A watched directory being removed surfaces as an error; just drop it
+      watcher.on('error', () => {
+        watcher.close();
+        this.watchers.delete(dir);
+      });
+
+      this.watchers.set(dir, watcher);
+    } catch {
+      // Unwatchable directory (permissions, already gone): skip it
+    }
+  }
+
+  private onEvent(dir: string, filename: string): void {
+    if (this.closed) {
+      return;
+    }
+
+    const absolute = path.join(dir, filename);
+
+    fs.promises.stat(absolute).then(
+      (stats) => {
+        if (this.closed) {
+          return;
+        }
+        if (stats.isDirectory()) {
+          // New subtree: start watching it and index whatever it contains
+          if (!DEFAULT_EXCLUDED_DIRS.has(filename) && !this.isExcluded(absolute)) {
+            this.watchTree(absolute).catch(() => {});
+          }
+          return;
+        }
+        if (stats.isFile() && this.matches(absolute)) {
+          this.enqueue(absolute);
+        }
+      },
+      () => {
+        // Deleted or transient (editor temp file): nothing to reindex
+      }
+    );
+  }
+
+  private relative(absolute: string): string {
+    return path.relative(this.rootAbs, absolute).split(path.sep).join('/');
+  }
+
+  private isExcluded(absolute: string): boolean {
+    const relative = this.relative(absolute);
+    return this.excludes.some((regex) => regex.test(relative));
+  }
+
+  private matches(absolute: string): boolean {
+    const relative = this.relative(absolute);
+    if (this.includes.length > 0 && !this.includes.some((regex) => regex.test(relative))) {
+      return false;
+    }
+    return !this.excludes.some((regex) => regex.test(relative));
+  }
+
+  private enqueue(file: string): void {
+    if (this.pendingFiles.size === 0) {
+      this.firstChangeAt = Date.now();
+    }
+    this.pendingFiles.add(file);
+
+    if (this.debounceTimer) {
+      clearTimeout(this.debounceTimer);
+    }
+
+    // Debounce until the tree goes quiet, but never hold a batch longer
+    // than maxBatchDelayMs under sustained churn
+    const elapsed = Date.now() - this.firstChangeAt;
+    const delay = Math.max(0, Math.min(this.debounceMs, this.maxBatchDelayMs - elapsed));
+    this.debounceTimer = setTimeout(() => this.flush(), delay);
+  }
+
+  private flush(): void {
+    this.debounceTimer = null;
+    if (this.pendingFiles.size === 0) {
+      return;
+    }
+
+    const batch = Array.from(this.pendingFiles);
+    this.pendingFiles.clear();
+    this.emit('batch', batch);
+  }
+
+  get watchedDirectoryCount(): number {
+    return this.watchers.size;
+  }
+
+  get pendingCount(): number {
+    return this.pendingFiles.size;
+  }
+
+  close(): void {
+    this.closed = true;
+
+    if (this.debounceTimer) {
+      clearTimeout(this.debounceTimer);
+      this.debounceTimer = null;
+    }
+    this.pendingFiles.clear();
+
+    for (const watcher of this.watchers.values()) {
+      watcher.close();
+    }
+    this.watchers.clear();
+  }
+}
@@ -15,13 +15,16 @@ import {
   ListToolsRequestSchema,
   Tool,
 } from '@modelcontextprotocol/sdk/types.js';
-import { LightRAGBridge } from './lightrag-bridge.js';
+import { LightRAGBridgePool } from './bridge-pool.js';
+import { walkDirectoryBatches } from './directory-walker.js';
+import { DirectoryWatcher } from './file-watcher.js';
 import { LightRAGConfig } from './types.js';
 
 class LightRAGMCPServer {
   private server: Server;
-  private bridge: LightRAGBridge;
+  private bridge: LightRAGBridgePool;
   private config: LightRAGConfig;
+  private watchers = new Map<string, DirectoryWatcher>();
 
   constructor(config: LightRAGConfig) {
     this.config = config;
@@ -39,8 +42,8 @@ class LightRAGMCPServer {
       }
     );
 
-    // Initialize Python bridge
-    this.bridge = new LightRAGBridge(config);
+    // Initialize Python bridge pool (pool of 1 behaves like a single bridge)
+    this.bridge = new LightRAGBridgePool(config);
 
     // Setup handlers
     this.setupToolHandlers();
@@ -84,10 +87,196 @@ class LightRAGMCPServer {
                 items: { type: 'string' },
                 description: 'List of absolute file paths to index (e.g., ["/path/to/file.cpp", "/path/to/file.h"])',
               },
+              background: {
+                type: 'boolean',
+                description: 'Run indexing as a background job and return a job id immediately (poll with lightrag_get_job_status). Default: false.',
+                default: false,
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
             },
             required: ['file_paths'],
           },
         },
+        {
+          name: 'lightrag_index_directory',
+          description: 'Index a whole directory tree: walks it server-side with .gitignore support and streams file batches into the index, so clients do not have to enumerate file paths.',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              root: {
+                type: 'string',
+                description: 'Absolute path of the directory to index',
+              },
+              include: {
+                type: 'array',
+                items: { type: 'string' },
+                description: 'Glob patterns of files to include (e.g., ["**/*.cpp", "**/*.h"]). Default: all files.',
+              },
+              exclude: {
+                type: 'array',
+                items: { type: 'string' },
+                description: 'Glob patterns to exclude (in addition to .gitignore and defaults like node_modules)',
+              },
+              respect_gitignore: {
+                type: 'boolean',
+                description: 'Honor .gitignore files found in the tree (default: true)',
+                default: true,
+              },
+              max_files: {
+                type: 'number',
+                description: 'Stop after this many files (safety bound)',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
+            },
+            required: ['root'],
+          },
+        },
+        {
+          name: 'lightrag_watch_directory',
+          description: 'Continuously watch a directory tree and incrementally reindex changed files. Edits are debounced and batched, so queries see code that is seconds old and steady-state cost is proportional to churn, not tree size.',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              root: {
+                type: 'string',
+                description: 'Absolute path of the directory to watch',
+              },
+              include: {
+                type: 'array',
+                items: { type: 'string' },
+                description: 'Glob patterns of files to reindex on change (e.g., ["**/*.cpp", "**/*.h"]). Default: all files.',
+              },
+              exclude: {
+                type: 'array',
+                items: { type: 'string' },
+                description: 'Glob patterns to ignore (in addition to defaults like node_modules)',
+              },
+              debounce_ms: {
+                type: 'number',
+                description: 'Quiet period after the last change before reindexing (default: 500)',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to index changes into',
+              },
+            },
+            required: ['root'],
+          },
+        },
+        {
+          name: 'lightrag_unwatch_directory',
+          description: 'Stop watching a directory previously registered with lightrag_watch_directory',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              root: {
+                type: 'string',
+                description: 'Path passed to lightrag_watch_directory (omit to list active watches)',
+              },
+            },
+          },
+        },
+        {
+          name: 'lightrag_get_job_status',
+          description: 'Get progress of a background indexing job (files processed, errors, ETA)',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              job_id: {
+                type: 'string',
+                description: 'Job id returned by lightrag_index_codebase with background=true',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name the job belongs to',
+              },
+            },
+            required: ['job_id'],
+          },
+        },
+        {
+          name: 'lightrag_resume_job',
+          description: 'Resume an interrupted, cancelled, or failed background indexing job from its checkpoint. Already-indexed batches are skipped, so resuming costs seconds, not hours.',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              job_id: {
+                type: 'string',
+                description: 'Job id of the job to resume',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name the job belongs to',
+              },
+            },
+            required: ['job_id'],
+          },
+        },
+        {
+          name: 'lightrag_cancel_job',
+          description: 'Cancel a running background indexing job (stops at the next batch boundary; completed batches stay indexed)',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              job_id: {
+                type: 'string',
+                description: 'Job id of the running job to cancel',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name the job belongs to',
+              },
+            },
+            required: ['job_id'],
+          },
+        },
+        {
+          name: 'lightrag_export_index',
+          description: 'Export the current index (graph, vectors, caches, manifest) as a single compressed bundle file that can be shipped to another machine and restored there',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              output_path: {
+                type: 'string',
+                description: 'Path to write the bundle to (e.g. /backups/index.tar.gz)',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name to export',
+              },
+            },
+            required: ['output_path'],
+          },
+        },
+        {
+          name: 'lightrag_import_index',
+          description: 'Restore a previously exported index bundle into the working directory, replacing the need to re-index from source. Refuses to overwrite an existing index unless force is set.',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              bundle_path: {
+                type: 'string',
+                description: 'Path to a bundle created by lightrag_export_index',
+              },
+              force: {
+                type: 'boolean',
+                description: 'Overwrite an existing index (default: false)',
+                default: false,
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name to restore into',
+              },
+            },
+            required: ['bundle_path'],
+          },
+        },
         {
           name: 'lightrag_search_code',
           description: `Search codebase using graph-based retrieval. Modes:
@@ -149,6 +338,14 @@ class LightRAGMCPServer {
                 items: { type: 'string' },
                 description: 'Low-level keywords for search refinement',
               },
+              stream: {
+                type: 'boolean',
+                description: 'Stream the answer incrementally via progress notifications (default: true when the client sends a progress token)',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
             },
             required: ['query'],
           },
@@ -167,13 +364,56 @@ class LightRAGMCPServer {
                 type: 'object',
                 description: 'Optional metadata about the text',
               },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
             },
             required: ['text'],
           },
         },
+        {
+          name: 'lightrag_insert_texts',
+          description: 'Insert many text snippets (review comments, code selections) in one call. All items go through a single insert pipeline pass, amortizing the per-call overhead of lightrag_insert_text.',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              items: {
+                type: 'array',
+                items: {
+                  type: 'object',
+                  properties: {
+                    text: { type: 'string', description: 'Text content to insert' },
+                    metadata: { type: 'object', description: 'Optional metadata about the text' },
+                  },
+                  required: ['text'],
+                },
+                description: 'Snippets to insert',
+              },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
+            },
+            required: ['items'],
+          },
+        },
         {
           name: 'lightrag_get_indexing_status',
           description: 'Get current indexing status, storage size, and configuration',
+          inputSchema: {
+            type: 'object',
+            properties: {
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
+            },
+          },
+        },
+        {
+          name: 'lightrag_get_metrics',
+          description: 'Get per-request latency breakdown (queue/wire/handler percentiles), cache hit rates, and LLM/embedding call counts for performance diagnosis',
           inputSchema: {
             type: 'object',
             properties: {},
@@ -189,6 +429,10 @@ class LightRAGMCPServer {
                 type: 'string',
                 description: 'Name of the entity to query (e.g., "keymanager_iterator", "execute_method")',
               },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
             },
             required: ['entity_name'],
           },
@@ -215,6 +459,10 @@ class LightRAGMCPServer {
                 minimum: 1,
                 maximum: 3,
               },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
             },
             required: ['entity_name'],
           },
@@ -242,6 +490,10 @@ class LightRAGMCPServer {
                 minimum: 5,
                 maximum: 50,
               },
+              workspace: {
+                type: 'string',
+                description: 'Optional workspace name (configured via LIGHTRAG_WORKSPACES) to route this call to',
+              },
             },
             required: ['query'],
           },
@@ -260,15 +512,45 @@ class LightRAGMCPServer {
           case 'lightrag_index_codebase':
             return await this.handleIndexCodebase(args);
 
+          case 'lightrag_index_directory':
+            return await this.handleIndexDirectory(args);
+
+          case 'lightrag_watch_directory':
+            return await this.handleWatchDirectory(args);
+
+          case 'lightrag_unwatch_directory':
+            return await this.handleUnwatchDirectory(args);
+
+          case 'lightrag_get_job_status':
+            return await this.handleGetJobStatus(args);
+
+          case 'lightrag_resume_job':
+            return await this.handleResumeJob(args);
+
+          case 'lightrag_cancel_job':
+            return await this.handleCancelJob(args);
+
+          case 'lightrag_export_index':
+            return await this.handleExportIndex(args);
+
+          case 'lightrag_import_index':
+            return await this.handleImportIndex(args);
+
           case 'lightrag_search_code':
-            return await this.handleSearchCode(args);
+            return await this.handleSearchCode(args, request.params._meta?.progressToken);
 
           case 'lightrag_insert_text':
             return await this.handleInsertText(args);
 
+          case 'lightrag_insert_texts':
+            return await this.handleInsertTexts(args);
+
           case 'lightrag_get_indexing_status':
             return await this.handleGetIndexingStatus(args);
 
+          case 'lightrag_get_metrics':
+            return await this.handleGetMetrics(args);
+
           case 'lightrag_get_entity':
             return await this.handleGetEntity(args);
 
@@ -297,20 +579,35 @@ class LightRAGMCPServer {
   }
 
   private async handleIndexCodebase(args: any) {
-    const { file_paths } = args;
+    const { file_paths, background = false, workspace } = args;
 
     if (!Array.isArray(file_paths) || file_paths.length === 0) {
       throw new Error('file_paths must be a non-empty array');
     }
 
+    if (background) {
+      const job = await this.bridge.call('start_index_job', { file_paths, workspace });
+
+      return {
+        content: [
+          {
+            type: 'text',
+            text: `🚀 Started background indexing job \`${job.job_id}\` for ${job.total} files.
+
+Poll progress with \`lightrag_get_job_status\` (job_id: \`${job.job_id}\`) or cancel with \`lightrag_cancel_job\`.`,
+          },
+        ],
+      };
+    }
+
     console.log(`Indexing ${file_paths.length} files...`);
     const startTime = Date.now();
 
-    const result = await this.bridge.call('index_files', { file_paths });
+    const result = await this.bridge.call('index_files', { file_paths, workspace });
 
     const duration = ((Date.now() - startTime) / 1000).toFixed(2);
     
-    const summary = `✅ Indexed ${result.success_count}/${result.total} files in ${duration}s
+    const summary = `✅ Indexed ${result.success_count}/${result.total} files in ${duration}s (${result.new_count} new, ${result.updated_count} updated, ${result.skipped_count} unchanged)
 
 **Successfully indexed:**
 ${file_paths.slice(0, 10).map((f: string) => `- ${f}`).join('\n')}
@@ -330,53 +627,363 @@ ${result.errors.length > 5 ? `\n... and ${result.errors.length - 5} more` : ''}`
     };
   }
 
-  private async handleSearchCode(args: any) {
-    const { 
-      query, 
-      mode = 'hybrid', 
-      top_k = 20, 
+  private async handleIndexDirectory(args: any) {
+    const { root, include, exclude, respect_gitignore = true, max_files, workspace } = args;
+
+    if (!root || typeof root !== 'string') {
+      throw new Error('root must be a non-empty string');
+    }
+
+    console.log(`Indexing directory: ${root}`);
+    const startTime = Date.now();
+
+    const totals = {
+      total: 0,
+      success_count: 0,
+      skipped_count: 0,
+      new_count: 0,
+      updated_count: 0,
+      error_count: 0,
+    };
+    const errors: string[] = [];
+
+    // Stream batches to the wrapper as the walk produces them, so ingestion
+    // overlaps the tree walk instead of waiting for a full file list
+    let inFlight: Promise<void> | null = null;
+
+    const submit = (batch: string[]) =>
+      this.bridge
+        .call('index_files', { file_paths: batch, workspace }, { timeout: 600000 })
+        .then((result: any) => {
+          totals.total += result.total;
+          totals.success_count += result.success_count;
+          totals.skipped_count += result.skipped_count;
+          totals.new_count += result.new_count;
+          totals.updated_count += result.updated_count;
+          totals.error_count += result.error_count;
+          errors.push(...(result.errors || []));
+        });
+
+    for await (const batch of walkDirectoryBatches(root, {
+      include,
+      exclude,
+      respectGitignore: respect_gitignore,
+      maxFiles: max_files,
+    })) {
+      if (inFlight) {
+        await inFlight;
+      }
+      inFlight = submit(batch);
+    }
+    if (inFlight) {
+      await inFlight;
+    }
+
+    const duration = ((Date.now() - startTime) / 1000).toFixed(2);
+
+    const summary = `✅ Indexed directory ${root} in ${duration}s
+
+**Files:** ${totals.total} (${totals.new_count} new, ${totals.updated_count} updated, ${totals.skipped_count} unchanged)
+${totals.error_count > 0 ? `**Failed (${totals.error_count}):**
+${errors.slice(0, 5).join('\n')}
+${errors.length > 5 ? `\n... and ${errors.length - 5} more` : ''}` : ''}`;
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: summary,
+        },
+      ],
+    };
+  }
+
+  private async handleWatchDirectory(args: any) {
+    const { root, include, exclude, debounce_ms, workspace } = args;
+
+    if (!root || typeof root !== 'string') {
+      throw new Error('root must be a non-empty string');
+    }
+
+    const key = `${workspace || 'default'}:${root}`;
+    if (this.watchers.has(key)) {
+      return {
+        content: [
+          {
+            type: 'text',
+            text: `Already watching ${root}${workspace ? ` (workspace: ${workspace})` : ''}.`,
+          },
+        ],
+      };
+    }
+
+    const watcher = new DirectoryWatcher(root, {
+      include,
+      exclude,
+      debounceMs: debounce_ms,
+    });
+
+    watcher.on('batch', (files: string[]) => {
+      console.log(`Watcher: reindexing ${files.length} changed file(s) under ${root}`);
+      this.bridge
+        .call('index_files', { file_paths: files, workspace }, { timeout: 600000 })
+        .catch((error: any) => {
+          console.error(`Watcher reindex failed for ${root}:`, error.message);
+        });
+    });
+
+    await watcher.start();
+    this.watchers.set(key, watcher);
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: `👀 Watching ${root} (${watcher.watchedDirectoryCount} directories)${workspace ? ` for workspace ${workspace}` : ''}.
+
+Changed files are debounced and reindexed automatically. Stop with \`lightrag_unwatch_directory\`.`,
+        },
+      ],
+    };
+  }
+
+  private async handleUnwatchDirectory(args: any) {
+    const { root } = args || {};
+
+    if (!root) {
+      const active = Array.from(this.watchers.keys());
+      return {
+        content: [
+          {
+            type: 'text',
+            text: active.length > 0
+              ? `Active watches:\n${active.map((k) => `- ${k}`).join('\n')}`
+              : 'No active watches.',
+          },
+        ],
+      };
+    }
+
+    // Watches are keyed by workspace:root; match on the root portion
+    let removed = 0;
+    for (const [key, watcher] of this.watchers.entries()) {
+      if (key.endsWith(`:${root}`)) {
+        watcher.close();
+        this.watchers.delete(key);
+        removed++;
+      }
+    }
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: removed > 0
+            ? `🛑 Stopped watching ${root}.`
+            : `No active watch for ${root}.`,
+        },
+      ],
+    };
+  }
+
+  private async handleGetJobStatus(args: any) {
+    const { job_id, workspace } = args;
+
+    if (!job_id || typeof job_id !== 'string') {
+      throw new Error('job_id must be a non-empty string');
+    }
+
+    const status = await this.bridge.call('get_job_status', { job_id, workspace });
+
+    const statusIcon: Record<string, string> = {
+      running: '⏳',
+      completed: '✅',
+      failed: '❌',
+      cancelled: '🛑',
+      interrupted: '⏸️',
+    };
+
+    const statusText = `## Indexing Job \`${job_id}\`
+
+**Status:** ${statusIcon[status.status] || ''} ${status.status}
+**Progress:** ${status.processed}/${status.total} files
+**Indexed:** ${status.success_count} | **Unchanged:** ${status.skipped_count} | **Errors:** ${status.error_count}
+**Elapsed:** ${status.elapsed_seconds}s${status.eta_seconds !== undefined ? `\n**ETA:** ~${status.eta_seconds}s` : ''}
+${status.errors && status.errors.length > 0 ? `\n**Errors:**\n${status.errors.slice(0, 5).join('\n')}` : ''}`;
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: statusText,
+        },
+      ],
+    };
+  }
+
+  private async handleResumeJob(args: any) {
+    const { job_id, workspace } = args;
+
+    if (!job_id || typeof job_id !== 'string') {
+      throw new Error('job_id must be a non-empty string');
+    }
+
+    const result = await this.bridge.call('resume_index_job', { job_id, workspace });
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: result.resumed
+            ? `▶️ Resumed indexing job \`${job_id}\` (${result.total} files; already-indexed batches are skipped). Poll progress with \`lightrag_get_job_status\`.`
+            : `Job \`${job_id}\` is already running.`,
+        },
+      ],
+    };
+  }
+
+  private async handleCancelJob(args: any) {
+    const { job_id, workspace } = args;
+
+    if (!job_id || typeof job_id !== 'string') {
+      throw new Error('job_id must be a non-empty string');
+    }
+
+    const result = await this.bridge.call('cancel_job', { job_id, workspace });
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: result.cancelled
+            ? `🛑 Cancellation requested for job \`${job_id}\`. It will stop at the next batch boundary; completed batches remain indexed.`
+            : `Job \`${job_id}\` is not running (status: ${result.status}).`,
+        },
+      ],
+    };
+  }
+
+  private async handleExportIndex(args: any) {
+    const { output_path, workspace } = args;
+
+    if (!output_path || typeof output_path !== 'string') {
+      throw new Error('output_path must be a non-empty string');
+    }
+
+    const result = await this.bridge.call(
+      'export_index_bundle',
+      { output_path, workspace },
+      { timeout: 600000 }
+    );
+
+    const sizeMb = (result.size_bytes / (1024 * 1024)).toFixed(1);
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: `📦 Exported index bundle to \`${result.bundle_path}\` (${result.files} files, ${sizeMb} MB, ${result.documents} documents). Restore it with \`lightrag_import_index\` or the LIGHTRAG_INDEX_BUNDLE environment variable.`,
+        },
+      ],
+    };
+  }
+
+  private async handleImportIndex(args: any) {
+    const { bundle_path, force = false, workspace } = args;
+
+    if (!bundle_path || typeof bundle_path !== 'string') {
+      throw new Error('bundle_path must be a non-empty string');
+    }
+
+    const result = await this.bridge.call(
+      'import_index_bundle',
+      { bundle_path, force, workspace },
+      { timeout: 600000 }
+    );
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: `✅ Restored index bundle from \`${bundle_path}\` (${result.manifest_entries} indexed files, ${result.documents} documents). The index is ready to query — no re-indexing needed.`,
+        },
+      ],
+    };
+  }
+
+  private async handleSearchCode(args: any, progressToken?: string | number) {
+    const {
+      query,
+      mode = 'hybrid',
+      top_k = 20,
       only_context = false,
       response_type = 'Multiple Paragraphs',
       max_token_for_text_unit = 4000,
       max_token_for_global_context = 4000,
       max_token_for_local_context = 4000,
       hl_keywords,
-      ll_keywords
+      ll_keywords,
+      stream,
+      workspace
     } = args;
 
     if (!query || typeof query !== 'string') {
       throw new Error('query must be a non-empty string');
     }
 
-    console.log(`Searching: "${query}" (mode=${mode})`);
+    // Stream when the client can receive progress and hasn't opted out
+    const shouldStream = (stream !== false) && progressToken !== undefined && !only_context;
+
+    console.log(`Searching: "${query}" (mode=${mode}, stream=${shouldStream})`);
     const startTime = Date.now();
 
-    const result = await this.bridge.call('search_code', { 
-      query, 
-      mode, 
-      top_k, 
+    let streamedChars = 0;
+    const onChunk = shouldStream
+      ? (chunk: string) => {
+          streamedChars += chunk.length;
+          // Relay incremental answer content to the client; failures here
+          // must not break the search itself
+          this.server.notification({
+            method: 'notifications/progress',
+            params: {
+              progressToken: progressToken!,
+              progress: streamedChars,
+              message: chunk,
+            },
+          }).catch(() => {});
+        }
+      : undefined;
+
+    const result = await this.bridge.call('search_code', {
+      query,
+      mode,
+      top_k,
       only_context,
       response_type,
       max_token_for_text_unit,
       max_token_for_global_context,
       max_token_for_local_context,
       hl_keywords,
-      ll_keywords
-    });
+      ll_keywords,
+      stream: shouldStream,
+      workspace
+    }, { onChunk });
 
     const duration = ((Date.now() - startTime) / 1000).toFixed(2);
 
     let responseText: string;
 
     if (only_context) {
-      // Return structured context
+      // Return structured context: typed chunks/entities/relations arrays
+      const context = result.context || { chunks: [], entities: [], relations: [] };
+
       responseText = `## Search Context (mode: ${mode}, ${duration}s)
 
 **Query:** ${query}
+**Retrieved:** ${context.chunks.length} chunks, ${context.entities.length} entities, ${context.relations.length} relations
 
-**Raw Context:**
 \`\`\`json
-${JSON.stringify(result.answer, null, 2)}
+${JSON.stringify(context, null, 2)}
 \`\`\``;
     } else {
       // Return LLM-generated answer
@@ -399,7 +1006,7 @@ ${result.answer}`;
   }
 
   private async handleInsertText(args: any) {
-    const { text, metadata } = args;
+    const { text, metadata, workspace } = args;
 
     if (!text || typeof text !== 'string') {
       throw new Error('text must be a non-empty string');
@@ -408,7 +1015,7 @@ ${result.answer}`;
     console.log(`Inserting text content (${text.length} chars)...`);
     const startTime = Date.now();
 
-    const result = await this.bridge.call('insert_text', { text, metadata });
+    const result = await this.bridge.call('insert_text', { text, metadata, workspace });
 
     const duration = ((Date.now() - startTime) / 1000).toFixed(2);
     
@@ -427,8 +1034,49 @@ ${result.answer}`;
     };
   }
 
+  private async handleInsertTexts(args: any) {
+    const { items, workspace } = args;
+
+    if (!Array.isArray(items) || items.length === 0) {
+      throw new Error('items must be a non-empty array');
+    }
+
+    const totalChars = items.reduce(
+      (sum: number, item: any) => sum + (typeof item?.text === 'string' ? item.text.length : 0),
+      0
+    );
+
+    console.log(`Inserting ${items.length} text snippets (${totalChars} chars)...`);
+    const startTime = Date.now();
+
+    const result = await this.bridge.call('insert_texts', { items, workspace }, { timeout: 600000 });
+
+    const duration = ((Date.now() - startTime) / 1000).toFixed(2);
+
+    const failures = (result.results || [])
+      .map((r: any, i: number) => ({ ...r, index: i }))
+      .filter((r: any) => !r.success);
+
+    const summary = `${result.error_count === 0 ? '✅' : '⚠️'} Inserted ${result.success_count}/${result.total} snippets in ${duration}s
+
+**Content Length:** ${totalChars} characters
+${failures.length > 0 ? `**Failed (${failures.length}):**
+${failures.slice(0, 5).map((f: any) => `- item ${f.index}: ${f.message}`).join('\n')}
+${failures.length > 5 ? `\n... and ${failures.length - 5} more` : ''}` : ''}`;
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: summary,
+        },
+      ],
+    };
+  }
+
   private async handleGetIndexingStatus(args: any) {
-    const status = await this.bridge.call('get_indexing_status', {});
+    const { workspace } = args || {};
+    const status = await this.bridge.call('get_indexing_status', { workspace });
 
     const storageSizeMB = status.working_dir_size_bytes 
       ? (status.working_dir_size_bytes / (1024 * 1024)).toFixed(2) 
@@ -441,6 +1089,11 @@ ${result.answer}`;
 **Graph Storage:** ${status.storage_backends?.neo4j || 'NetworkX'}
 **Vector Storage:** ${status.storage_backends?.milvus || 'NanoVectorDB'}
 ${status.initialized ? `**Storage Size:** ${storageSizeMB} MB` : ''}
+${status.index_stats ? `**Indexed:** ${status.index_stats.documents} documents, ${status.index_stats.chunks} chunks (${(status.index_stats.content_bytes / (1024 * 1024)).toFixed(2)} MB of content)
+**Graph:** ${status.index_stats.entities} entities, ${status.index_stats.relations} relations` : ''}
+${Object.entries(status.backend_pools || {}).map(([name, pool]: [string, any]) => `**${name} pool:** ${pool.connected ? '✅ connected' : `❌ down (${pool.last_error || 'unknown'})`} — size ${pool.pool_size}, ${pool.in_flight_requests} in flight, ${pool.reconnects} reconnects`).join('\n')}
+${status.query_cache ? `**Query Cache:** ${status.query_cache.entries} entries (gen ${status.query_cache.generation}, ${status.query_cache.hits} hits / ${status.query_cache.misses} misses)` : ''}
+${status.embedding_cache ? `**Embedding Cache:** ${status.embedding_cache.entries} vectors (${status.embedding_cache.hits} hits / ${status.embedding_cache.misses} misses)` : ''}
 
 ${!status.initialized ? '⚠️  No files indexed yet. Use `lightrag_index_codebase` to start.' : ''}`;
 
@@ -454,22 +1107,77 @@ ${!status.initialized ? '⚠️  No files indexed yet. Use `lightrag_index_codeb
     };
   }
 
+  private async handleGetMetrics(args: any) {
+    // Bridge-side metrics (queue wait + wire time) come from memory;
+    // handler-side metrics come from each wrapper process over RPC
+    const bridgeMetrics = this.bridge.getMetrics();
+    const wrapperMetrics = await this.bridge.callAll('get_metrics', {});
+
+    const formatSummary = (s: any) =>
+      `avg ${s.avg_ms}ms, p50 ${s.p50_ms}ms, p95 ${s.p95_ms}ms, p99 ${s.p99_ms}ms (n=${s.count})`;
+
+    const sections: string[] = ['## LightRAG Performance Metrics'];
+
+    bridgeMetrics.forEach((metrics: any, i: number) => {
+      const lines: string[] = [`### Bridge (worker ${i})`];
+      lines.push(`**In-flight:** control=${metrics.in_flight.control}, interactive=${metrics.in_flight.interactive}, bulk=${metrics.in_flight.bulk} | **Queued:** control=${metrics.queue_depths.control}, interactive=${metrics.queue_depths.interactive}, bulk=${metrics.queue_depths.bulk}`);
+      for (const [method, stats] of Object.entries<any>(metrics.methods)) {
+        lines.push(`- \`${method}\`: queue ${formatSummary(stats.queue)}; wire ${formatSummary(stats.wire)}`);
+      }
+      sections.push(lines.join('\n'));
+    });
+
+    wrapperMetrics.forEach((metrics: any, i: number) => {
+      const lines: string[] = [`### Wrapper (worker ${i})`];
+      lines.push(`**In-flight:** ${metrics.in_flight}`);
+      for (const [method, stats] of Object.entries<any>(metrics.methods || {})) {
+        lines.push(`- \`${method}\`: handler ${formatSummary(stats)}`);
+      }
+      if (metrics.llm) {
+        lines.push(`**LLM:** ${metrics.llm.calls} calls, ~${metrics.llm.estimated_tokens} tokens`);
+      }
+      if (metrics.embedding) {
+        lines.push(`**Embeddings:** ${metrics.embedding.api_calls} API calls for ${metrics.embedding.texts_embedded} texts (cache: ${metrics.embedding.cache_hits} hits / ${metrics.embedding.cache_misses} misses)`);
+      }
+      if (metrics.query_cache) {
+        lines.push(`**Query cache:** ${metrics.query_cache.hits} hits / ${metrics.query_cache.misses} misses`);
+      }
+      sections.push(lines.join('\n'));
+    });
+
+    return {
+      content: [
+        {
+          type: 'text',
+          text: sections.join('\n\n'),
+        },
+      ],
+    };
+  }
+
   private async handleGetEntity(args: any) {
-    const { entity_name } = args;
+    const { entity_name, workspace } = args;
 
     if (!entity_name || typeof entity_name !== 'string') {
       throw new Error('entity_name must be a non-empty string');
     }
 
     console.log(`Getting entity: ${entity_name}`);
-    const result = await this.bridge.call('get_entity', { entity_name });
+    const result = await this.bridge.call('get_entity', { entity_name, workspace });
+
+    const responseText = result.found
+      ? `## Entity: ${entity_name}
 
-    const responseText = `## Entity: ${entity_name}
+**Type:** ${result.entity_type}
+**Relationships:** ${result.degree}
 
 **Description:**
 ${result.description}
 
-**Search Mode:** ${result.search_mode}`;
+**Source:** ${result.source_id}`
+      : `## Entity: ${entity_name}
+
+❌ ${result.description}`;
 
     return {
       content: [
@@ -482,22 +1190,26 @@ ${result.description}
   }
 
   private async handleGetRelationships(args: any) {
-    const { entity_name, relation_type, depth = 1 } = args;
+    const { entity_name, relation_type, depth = 1, workspace } = args;
 
     if (!entity_name || typeof entity_name !== 'string') {
       throw new Error('entity_name must be a non-empty string');
     }
 
     console.log(`Getting relationships for: ${entity_name} (type=${relation_type}, depth=${depth})`);
-    const result = await this.bridge.call('get_relationships', { entity_name, relation_type, depth });
+    const result = await this.bridge.call('get_relationships', { entity_name, relation_type, depth, workspace });
+
+    const relationshipLines = (result.relationships || [])
+      .map((rel: any) => `- ${rel.source} → ${rel.target}${rel.description ? `: ${rel.description}` : ''}`)
+      .join('\n');
 
     const responseText = `## Relationships: ${entity_name}
 
 ${relation_type ? `**Type Filter:** ${relation_type}` : '**Type:** All relationships'}
 **Depth:** ${depth}
+**Found:** ${result.relationships?.length || 0}
 
-**Relationships:**
-${result.relationships}`;
+${result.found === false ? `❌ Entity '${entity_name}' not found in the knowledge graph` : relationshipLines || '_No relationships found_'}`;
 
     return {
       content: [
@@ -510,7 +1222,7 @@ ${result.relationships}`;
   }
 
   private async handleVisualizeSubgraph(args: any) {
-    const { query, format = 'mermaid', max_nodes = 20 } = args;
+    const { query, format = 'mermaid', max_nodes = 20, workspace } = args;
 
     if (!query || typeof query !== 'string') {
       throw new Error('query must be a non-empty string');
@@ -519,7 +1231,7 @@ ${result.relationships}`;
     console.log(`Visualizing: "${query}" (format=${format}, max_nodes=${max_nodes})`);
     const startTime = Date.now();
 
-    const result = await this.bridge.call('visualize_subgraph', { query, format, max_nodes });
+    const result = await this.bridge.call('visualize_subgraph', { query, format, max_nodes, workspace });
 
     if (result.error) {
       throw new Error(result.error);
@@ -563,6 +1275,11 @@ ${result.diagram}
   }
 
   async cleanup() {
+    for (const watcher of this.watchers.values()) {
+      watcher.close();
+    }
+    this.watchers.clear();
+
     await this.bridge.stop();
   }
 }
@@ -589,8 +1306,23 @@ async function main() {
     neo4jUri: process.env.NEO4J_URI,
     neo4jUsername: process.env.NEO4J_USERNAME || 'neo4j',
     neo4jPassword: process.env.NEO4J_PASSWORD,
+    poolSize: parseInt(process.env.LIGHTRAG_POOL_SIZE || '1', 10),
+    maxWarmWorkspaces: parseInt(process.env.LIGHTRAG_MAX_WARM_WORKSPACES || '3', 10),
+    indexBundle: process.env.LIGHTRAG_INDEX_BUNDLE,
+    backendPoolSize: parseInt(process.env.LIGHTRAG_BACKEND_POOL_SIZE || '8', 10),
+    backendWarmup: process.env.LIGHTRAG_BACKEND_WARMUP !== '0',
   };
 
+  // Optional workspace map (JSON object of name -> working_dir) lets one
+  // server instance serve several repos
+  if (process.env.LIGHTRAG_WORKSPACES) {
+    try {
+      config.workspaces = JSON.parse(process.env.LIGHTRAG_WORKSPACES);
+    } catch (error) {
+      console.error('Ignoring invalid LIGHTRAG_WORKSPACES (must be a JSON object):', error);
+    }
+  }
+
   const server = new LightRAGMCPServer(config);
 
   try {
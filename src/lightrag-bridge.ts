@@ -1,5 +1,6 @@
 import { spawn, ChildProcess } from 'child_process';
 import { EventEmitter } from 'events';
+import { Worker } from 'worker_threads';
 import * as readline from 'readline';
 import * as path from 'path';
 import { fileURLToPath } from 'url';
@@ -20,6 +21,14 @@ export interface BridgeConfig extends LightRAGConfig {
   autoRestart?: boolean;
   maxRestarts?: number;
   healthCheckInterval?: number;
+  maxConcurrentRequests?: number;
+  readyTimeout?: number;
+  framing?: 'ndjson' | 'length-prefixed';
+  maxInFlight?: Partial<Record<PriorityClass, number>>;
+  maxQueueDepth?: number;
+  drainTimeout?: number;
+  controlChannel?: boolean;
+  parseOffloadThreshold?: number;
 }
 
 interface PendingRequest {
@@ -28,10 +37,91 @@ interface PendingRequest {
   timeout: NodeJS.Timeout;
 }
 
+export type PriorityClass = 'control' | 'interactive' | 'bulk';
+
+interface QueuedRequest {
+  method: string;
+  params: Record<string, any>;
+  options?: CallOptions;
+  resolve: (value: any) => void;
+  reject: (error: Error) => void;
+  enqueuedAt: number;
+}
+
+interface MethodSamples {
+  queueMs: number[];
+  wireMs: number[];
+}
+
+export interface LatencySummary {
+  count: number;
+  avg_ms: number;
+  p50_ms: number;
+  p95_ms: number;
+  p99_ms: number;
+}
+
+const METRICS_MAX_SAMPLES = 500;
+
+// Responses at or above this size are JSON.parsed off the event loop;
+// smaller ones (the vast majority) stay on the inline fast path
+const DEFAULT_PARSE_OFFLOAD_THRESHOLD = 256 * 1024;
+
+// The parse worker is spawned from an inline script so it needs no
+// companion file in dist/ and works identically under ts-jest
+const PARSE_WORKER_SOURCE = `
+const { parentPort } = require('worker_threads');
+parentPort.on('message', (text) => {
+  try {
+    parentPort.postMessage({ ok: true, value: JSON.parse(text) });
+  } catch (error) {
+    parentPort.postMessage({ ok: false, error: String((error && error.message) || error) });
+  }
+});
+`;
+
+function percentile(samples: number[], fraction: number): number {
+  const ordered = [...samples].sort((a, b) => a - b);
+  const index = Math.min(ordered.length - 1, Math.floor(fraction * ordered.length));
+  return ordered[index];
+}
+
+function summarize(samples: number[]): LatencySummary {
+  return {
+    count: samples.length,
+    avg_ms: Math.round((samples.reduce((a, b) => a + b, 0) / samples.length) * 100) / 100,
+    p50_ms: Math.round(percentile(samples, 0.5) * 100) / 100,
+    p95_ms: Math.round(percentile(samples, 0.95) * 100) / 100,
+    p99_ms: Math.round(percentile(samples, 0.99) * 100) / 100,
+  };
+}
+
+export interface CallOptions {
+  timeout?: number;
+  onChunk?: (chunk: string) => void;
+}
+
+// Health/control traffic preempts searches, which preempt bulk indexing
+const PRIORITY_ORDER: PriorityClass[] = ['control', 'interactive', 'bulk'];
+
+const BULK_METHODS = new Set(['index_files', 'insert_text', 'insert_texts', 'start_index_job', 'resume_index_job', 'export_index_bundle', 'import_index_bundle']);
+const CONTROL_METHODS = new Set(['ping', 'get_job_status', 'cancel_job']);
+
+function classifyMethod(method: string): PriorityClass {
+  if (CONTROL_METHODS.has(method)) {
+    return 'control';
+  }
+  if (BULK_METHODS.has(method)) {
+    return 'bulk';
+  }
+  return 'interactive';
+}
+
 export class LightRAGBridge extends EventEmitter {
   private process: ChildProcess | null = null;
   private requestId = 0;
   private pendingRequests = new Map<number, PendingRequest>();
+  private streamHandlers = new Map<number, (chunk: string) => void>();
   private healthCheckInterval: NodeJS.Timeout | null = null;
   private restartCount = 0;
   private isShuttingDown = false;
@@ -42,7 +132,50 @@ export class LightRAGBridge extends EventEmitter {
   private readonly autoRestart: boolean;
   private readonly maxRestarts: number;
   private readonly healthCheckIntervalMs: number;
-  
+  private readonly framing: 'ndjson' | 'length-prefixed';
+  private readonly maxInFlight: Record<PriorityClass, number>;
+  private readonly maxQueueDepth: number;
+  private readonly drainTimeoutMs: number;
+  private readonly useControlChannel: boolean;
+
+  // Dedicated control-plane pipe (fd 3): ping/status/cancel bypass the
+  // data pipe entirely so liveness checks never queue behind bulk frames
+  private controlIn: NodeJS.WritableStream | null = null;
+
+  // Scheduler state: per-class in-flight counts and wait queues
+  private inFlight: Record<PriorityClass, number> = { control: 0, interactive: 0, bulk: 0 };
+  private queues: Record<PriorityClass, QueuedRequest[]> = {
+    control: [],
+    interactive: [],
+    bulk: [],
+  };
+
+  // Per-method queue-wait and wire-time samples for metrics reporting
+  private methodMetrics = new Map<string, MethodSamples>();
+
+  // In-flight search coalescing: identical queries share one wrapper call
+  private inFlightSearches = new Map<string, {
+    promise: Promise<any>;
+    chunkHandlers: Array<(chunk: string) => void>;
+  }>();
+  private coalescedCount = 0;
+
+  // Incremental decode state for length-prefixed framing
+  private frameChunks: Buffer[] = [];
+  private frameBytes = 0;
+  private frameExpected = -1;
+
+  // Over-threshold payloads are parsed on a worker thread so one fat
+  // only_context result cannot stall every other caller. While a worker
+  // parse is in flight, later lines queue behind it to preserve message
+  // order (streamed chunks before their final response, etc.)
+  private parseWorker: Worker | null = null;
+  private parseQueue: string[] = [];
+  private parseBusy = false;
+  private offloadedParses = 0;
+  private readonly parseOffloadThreshold: number;
+
+
   constructor(private config: BridgeConfig) {
     super();
     
@@ -52,6 +185,16 @@ export class LightRAGBridge extends EventEmitter {
     this.autoRestart = config.autoRestart !== false; // true by default
     this.maxRestarts = config.maxRestarts || 3;
     this.healthCheckIntervalMs = config.healthCheckInterval || 30000; // 30 seconds
+    this.framing = config.framing || 'length-prefixed';
+    this.maxInFlight = {
+      control: config.maxInFlight?.control ?? 4,
+      interactive: config.maxInFlight?.interactive ?? 8,
+      bulk: config.maxInFlight?.bulk ?? 2,
+    };
+    this.maxQueueDepth = config.maxQueueDepth ?? 100;
+    this.drainTimeoutMs = config.drainTimeout ?? 30000;
+    this.useControlChannel = config.controlChannel !== false;
+    this.parseOffloadThreshold = config.parseOffloadThreshold ?? DEFAULT_PARSE_OFFLOAD_THRESHOLD;
   }
   
   async start(): Promise<void> {
@@ -75,6 +218,32 @@ export class LightRAGBridge extends EventEmitter {
         OPENAI_MODEL: this.config.openaiModel || 'gpt-4',
         OPENAI_EMBEDDING_MODEL: this.config.openaiEmbeddingModel || 'text-embedding-ada-002',
       };
+
+      if (this.config.maxConcurrentRequests) {
+        env.LIGHTRAG_MAX_CONCURRENT_REQUESTS = String(this.config.maxConcurrentRequests);
+      }
+
+      // Negotiate the bridge protocol framing with the wrapper
+      env.LIGHTRAG_FRAMING = this.framing;
+
+      // Workspace map for multi-repo routing (name -> working_dir)
+      if (this.config.workspaces && Object.keys(this.config.workspaces).length > 0) {
+        env.LIGHTRAG_WORKSPACES = JSON.stringify(this.config.workspaces);
+      }
+      if (this.config.maxWarmWorkspaces) {
+        env.LIGHTRAG_MAX_WARM_WORKSPACES = String(this.config.maxWarmWorkspaces);
+      }
+      // Prebuilt bundle to restore on first start (air-gapped deployments)
+      if (this.config.indexBundle) {
+        env.LIGHTRAG_INDEX_BUNDLE = this.config.indexBundle;
+      }
+      // Backend connection pool sizing and eager warmup (Neo4j/Milvus)
+      if (this.config.backendPoolSize) {
+        env.LIGHTRAG_BACKEND_POOL_SIZE = String(this.config.backendPoolSize);
+      }
+      if (this.config.backendWarmup === false) {
+        env.LIGHTRAG_BACKEND_WARMUP = '0';
+      }
       
       if (this.config.milvusAddress) {
         env.MILVUS_URI = this.config.milvusAddress;
@@ -85,25 +254,61 @@ export class LightRAGBridge extends EventEmitter {
         env.NEO4J_PASSWORD = this.config.neo4jPassword || '';
       }
       
+      // fds 3/4 carry the control channel (ping, job status, cancel) when
+      // enabled, so health checks stay responsive under data-plane load
+      if (this.useControlChannel) {
+        env.LIGHTRAG_CONTROL_CHANNEL = '1';
+      }
+
       this.process = spawn(this.pythonPath, [this.scriptPath], {
         env,
-        stdio: ['pipe', 'pipe', 'pipe'],
+        stdio: this.useControlChannel
+          ? ['pipe', 'pipe', 'pipe', 'pipe', 'pipe']
+          : ['pipe', 'pipe', 'pipe'],
       });
-      
+
       if (!this.process.stdin || !this.process.stdout || !this.process.stderr) {
         reject(new Error('Failed to create stdio streams'));
         return;
       }
+
+      // Control channel: NDJSON both ways (messages are tiny), with its own
+      // reader so responses are matched by id like everything else
+      this.controlIn = null;
+      const controlOut = this.process.stdio?.[4] as NodeJS.ReadableStream | undefined;
+      if (this.useControlChannel && controlOut && this.process.stdio?.[3]) {
+        this.controlIn = this.process.stdio[3] as NodeJS.WritableStream;
+
+        const controlRl = readline.createInterface({
+          input: controlOut,
+          crlfDelay: Infinity,
+        });
+        controlRl.on('line', (line) => {
+          this.handleStdout(line);
+        });
+      }
       
       // Setup stdout reader (JSON-RPC responses)
-      const rl = readline.createInterface({
-        input: this.process.stdout,
-        crlfDelay: Infinity,
-      });
-      
-      rl.on('line', (line) => {
-        this.handleStdout(line);
-      });
+      if (this.framing === 'length-prefixed') {
+        // Length-prefixed frames decode incrementally from the raw stream,
+        // avoiding readline's line scanning over multi-MB payloads
+        this.frameChunks = [];
+        this.frameBytes = 0;
+        this.frameExpected = -1;
+
+        this.process.stdout.on('data', (chunk: Buffer) => {
+          this.handleFramedData(chunk);
+        });
+      } else {
+        const rl = readline.createInterface({
+          input: this.process.stdout,
+          crlfDelay: Infinity,
+        });
+
+        rl.on('line', (line) => {
+          this.handleStdout(line);
+        });
+      }
       
       // Setup stderr reader (logs)
       const stderrRl = readline.createInterface({
@@ -126,32 +331,200 @@ export class LightRAGBridge extends EventEmitter {
         reject(error);
       });
       
-      // Wait for process to be ready
-      setTimeout(() => {
+      // Wait for the wrapper's explicit ready notification so the backend
+      // is warm before the first tool call (LightRAG + Neo4j/Milvus init
+      // can take 10+ seconds)
+      const readyTimeoutMs = this.config.readyTimeout || 120000;
+
+      const onNotification = (method: string, params: any) => {
+        if (method !== 'ready') {
+          return;
+        }
+        clearTimeout(readyTimer);
+        this.removeListener('notification', onNotification);
+
+        if (params && params.ok === false) {
+          // Wrapper is alive but eager init failed; it will retry lazily,
+          // so surface the error without failing the spawn
+          this.emit('error', new Error(`Wrapper initialization failed: ${params.error}`));
+        }
         resolve();
-      }, 1000); // Give process time to start
+      };
+
+      const readyTimer = setTimeout(() => {
+        this.removeListener('notification', onNotification);
+        reject(new Error(`Wrapper not ready after ${readyTimeoutMs}ms`));
+      }, readyTimeoutMs);
+
+      this.on('notification', onNotification);
     });
   }
   
-  private handleStdout(line: string): void {
-    try {
-      const response: JSONRPCResponse = JSON.parse(line);
-      
-      const pending = this.pendingRequests.get(response.id);
-      if (pending) {
-        clearTimeout(pending.timeout);
-        this.pendingRequests.delete(response.id);
-        
-        if (response.error) {
-          pending.reject(new Error(response.error.message));
-        } else {
-          pending.resolve(response.result);
+  private handleFramedData(chunk: Buffer): void {
+    this.frameChunks.push(chunk);
+    this.frameBytes += chunk.length;
+
+    // Extract as many complete frames as the buffered data contains
+    for (;;) {
+      if (this.frameExpected < 0) {
+        if (this.frameBytes < 4) {
+          return;
         }
+        this.frameExpected = this.consumeBytes(4).readUInt32BE(0);
       }
+
+      if (this.frameBytes < this.frameExpected) {
+        return;
+      }
+
+      const payload = this.consumeBytes(this.frameExpected);
+      this.frameExpected = -1;
+      this.handleStdout(payload.toString('utf-8'));
+    }
+  }
+
+  private consumeBytes(count: number): Buffer {
+    const out = Buffer.allocUnsafe(count);
+    let offset = 0;
+
+    while (offset < count) {
+      const head = this.frameChunks[0];
+      const take = Math.min(head.length, count - offset);
+      head.copy(out, offset, 0, take);
+
+      if (take === head.length) {
+        this.frameChunks.shift();
+      } else {
+        this.frameChunks[0] = head.subarray(take);
+      }
+      offset += take;
+    }
+
+    this.frameBytes -= count;
+    return out;
+  }
+
+  private encodeRequest(request: JSONRPCRequest): Buffer | string {
+    if (this.framing === 'length-prefixed') {
+      const payload = Buffer.from(JSON.stringify(request), 'utf-8');
+      const header = Buffer.allocUnsafe(4);
+      header.writeUInt32BE(payload.length, 0);
+      return Buffer.concat([header, payload]);
+    }
+    return JSON.stringify(request) + '\n';
+  }
+
+  private handleStdout(line: string): void {
+    // Small messages (control traffic, notifications, typical responses)
+    // parse inline; big ones queue for the worker. Once anything is
+    // queued, everything queues behind it so ordering is preserved.
+    if (this.parseBusy || line.length >= this.parseOffloadThreshold) {
+      this.parseQueue.push(line);
+      this.pumpParseQueue();
+      return;
+    }
+
+    try {
+      this.dispatchMessage(JSON.parse(line));
     } catch (error) {
       this.emit('error', new Error(`Failed to parse JSON-RPC response: ${line}`));
     }
   }
+
+  private pumpParseQueue(): void {
+    if (this.parseBusy) {
+      return;
+    }
+
+    while (this.parseQueue.length > 0) {
+      const line = this.parseQueue[0];
+
+      if (line.length < this.parseOffloadThreshold) {
+        this.parseQueue.shift();
+        try {
+          this.dispatchMessage(JSON.parse(line));
+        } catch (error) {
+          this.emit('error', new Error(`Failed to parse JSON-RPC response: ${line}`));
+        }
+        continue;
+      }
+
+      // Hand the frame to the worker; resume draining when it answers
+      this.parseQueue.shift();
+      this.parseBusy = true;
+      this.offloadedParses++;
+      this.getParseWorker().postMessage(line);
+      return;
+    }
+  }
+
+  private getParseWorker(): Worker {
+    if (this.parseWorker) {
+      return this.parseWorker;
+    }
+
+    const worker = new Worker(PARSE_WORKER_SOURCE, { eval: true });
+    // Never keep the parent process alive just for the parser
+    worker.unref();
+
+    worker.on('message', (result: { ok: boolean; value?: any; error?: string }) => {
+      this.parseBusy = false;
+      if (result.ok) {
+        this.dispatchMessage(result.value);
+      } else {
+        this.emit('error', new Error(`Failed to parse JSON-RPC response: ${result.error}`));
+      }
+      this.pumpParseQueue();
+    });
+
+    worker.on('error', (error) => {
+      // Worker died (OOM, internal error): fall back to inline parsing
+      this.parseBusy = false;
+      this.parseWorker = null;
+      this.emit('error', new Error(`Parse worker failed: ${error.message}`));
+      this.pumpParseQueue();
+    });
+
+    this.parseWorker = worker;
+    return worker;
+  }
+
+  private stopParseWorker(): void {
+    if (this.parseWorker) {
+      this.parseWorker.terminate().catch(() => {});
+      this.parseWorker = null;
+    }
+    this.parseQueue = [];
+    this.parseBusy = false;
+  }
+
+  private dispatchMessage(response: JSONRPCResponse): void {
+    // Notifications (no id) carry out-of-band data such as streamed
+    // search chunks; route them to any registered stream handler
+    if (response.id === undefined || response.id === null) {
+      const notification = response as any;
+      if (notification.method === 'search_chunk' && notification.params) {
+        const handler = this.streamHandlers.get(notification.params.id);
+        if (handler) {
+          handler(notification.params.chunk);
+        }
+      }
+      this.emit('notification', notification.method, notification.params);
+      return;
+    }
+
+    const pending = this.pendingRequests.get(response.id);
+    if (pending) {
+      clearTimeout(pending.timeout);
+      this.pendingRequests.delete(response.id);
+
+      if (response.error) {
+        pending.reject(new Error(response.error.message));
+      } else {
+        pending.resolve(response.result);
+      }
+    }
+  }
   
   private handleStderr(line: string): void {
     // Emit stderr as log event
@@ -168,9 +541,14 @@ export class LightRAGBridge extends EventEmitter {
       pending.reject(new Error(`Process exited with code ${code}`));
     }
     this.pendingRequests.clear();
-    
+    this.rejectQueued(new Error(`Process exited with code ${code}`));
+
     this.process = null;
-    
+    this.controlIn = null;
+    // Drop undecoded frames from the dead process; their requests were
+    // just rejected above
+    this.parseQueue = [];
+
     // Auto-restart if enabled and not shutting down
     if (this.autoRestart && !this.isShuttingDown && this.restartCount < this.maxRestarts) {
       this.restartCount++;
@@ -210,12 +588,170 @@ export class LightRAGBridge extends EventEmitter {
   async call(
     method: string,
     params: Record<string, any> = {},
-    options?: { timeout?: number }
+    options?: CallOptions
   ): Promise<any> {
     if (!this.process || !this.process.stdin) {
       throw new Error('Bridge not started');
     }
-    
+
+    // Identical searches issued while one is already in flight share that
+    // request instead of each paying full LLM cost
+    if (method === 'search_code') {
+      return this.coalescedSearch(params, options);
+    }
+
+    return this.schedule(method, params, options);
+  }
+
+  private coalescedSearch(
+    params: Record<string, any>,
+    options?: CallOptions
+  ): Promise<any> {
+    const key = JSON.stringify(
+      Object.entries(params).sort(([a], [b]) => a.localeCompare(b))
+    );
+
+    const existing = this.inFlightSearches.get(key);
+    if (existing) {
+      this.coalescedCount++;
+      // Late subscribers miss chunks streamed before they joined, but they
+      // still get the full answer from the shared result
+      if (options?.onChunk) {
+        existing.chunkHandlers.push(options.onChunk);
+      }
+      this.emit('coalesced', { method: 'search_code', key });
+      return existing.promise;
+    }
+
+    const chunkHandlers: Array<(chunk: string) => void> = [];
+    if (options?.onChunk) {
+      chunkHandlers.push(options.onChunk);
+    }
+
+    const fanOut = (chunk: string) => {
+      for (const handler of chunkHandlers) {
+        try {
+          handler(chunk);
+        } catch {
+          // One subscriber's failure must not break the others
+        }
+      }
+    };
+
+    const promise = this.schedule('search_code', params, { ...options, onChunk: fanOut })
+      .finally(() => this.inFlightSearches.delete(key));
+
+    this.inFlightSearches.set(key, { promise, chunkHandlers });
+    return promise;
+  }
+
+  private async schedule(
+    method: string,
+    params: Record<string, any>,
+    options?: CallOptions
+  ): Promise<any> {
+    const priorityClass = classifyMethod(method);
+
+    // Free slot: dispatch immediately
+    if (this.inFlight[priorityClass] < this.maxInFlight[priorityClass]) {
+      return this.dispatch(priorityClass, method, params, options);
+    }
+
+    // Saturated: queue with bounded depth, fast-failing when full so
+    // callers get backpressure feedback instead of a distant timeout
+    const queue = this.queues[priorityClass];
+    if (queue.length >= this.maxQueueDepth) {
+      throw new Error(
+        `Bridge queue full for ${priorityClass} requests ` +
+        `(${queue.length} queued, ${this.inFlight[priorityClass]} in flight)`
+      );
+    }
+
+    return new Promise((resolve, reject) => {
+      queue.push({ method, params, options, resolve, reject, enqueuedAt: Date.now() });
+      this.emit('queued', { method, class: priorityClass, depth: queue.length });
+    });
+  }
+
+  private async dispatch(
+    priorityClass: PriorityClass,
+    method: string,
+    params: Record<string, any>,
+    options?: CallOptions,
+    queuedMs = 0
+  ): Promise<any> {
+    this.inFlight[priorityClass]++;
+    const start = Date.now();
+    try {
+      return await this.sendRequest(method, params, options);
+    } finally {
+      this.recordSample(method, queuedMs, Date.now() - start);
+      this.inFlight[priorityClass]--;
+      this.pumpQueues();
+    }
+  }
+
+  private recordSample(method: string, queueMs: number, wireMs: number): void {
+    let samples = this.methodMetrics.get(method);
+    if (!samples) {
+      samples = { queueMs: [], wireMs: [] };
+      this.methodMetrics.set(method, samples);
+    }
+    samples.queueMs.push(queueMs);
+    samples.wireMs.push(wireMs);
+    if (samples.queueMs.length > METRICS_MAX_SAMPLES) {
+      samples.queueMs.splice(0, samples.queueMs.length - METRICS_MAX_SAMPLES);
+      samples.wireMs.splice(0, samples.wireMs.length - METRICS_MAX_SAMPLES);
+    }
+  }
+
+  private pumpQueues(): void {
+    for (const priorityClass of PRIORITY_ORDER) {
+      while (
+        this.queues[priorityClass].length > 0 &&
+        this.inFlight[priorityClass] < this.maxInFlight[priorityClass] &&
+        this.process &&
+        this.process.stdin
+      ) {
+        const queued = this.queues[priorityClass].shift()!;
+        const queuedMs = Date.now() - queued.enqueuedAt;
+        this.dispatch(priorityClass, queued.method, queued.params, queued.options, queuedMs)
+          .then(queued.resolve, queued.reject);
+      }
+    }
+  }
+
+  getMetrics(): Record<string, any> {
+    const methods: Record<string, { queue: LatencySummary; wire: LatencySummary }> = {};
+    for (const [method, samples] of this.methodMetrics.entries()) {
+      if (samples.wireMs.length === 0) {
+        continue;
+      }
+      methods[method] = {
+        queue: summarize(samples.queueMs),
+        wire: summarize(samples.wireMs),
+      };
+    }
+
+    return {
+      methods,
+      in_flight: { ...this.inFlight },
+      queue_depths: this.queueDepths,
+      pending: this.pendingRequests.size,
+      coalesced_searches: this.coalescedCount,
+      offloaded_parses: this.offloadedParses,
+    };
+  }
+
+  private async sendRequest(
+    method: string,
+    params: Record<string, any> = {},
+    options?: CallOptions
+  ): Promise<any> {
+    if (!this.process || !this.process.stdin) {
+      throw new Error('Bridge not started');
+    }
+
     const id = ++this.requestId;
     const request: JSONRPCRequest = {
       jsonrpc: '2.0',
@@ -223,23 +759,45 @@ export class LightRAGBridge extends EventEmitter {
       method,
       params,
     };
-    
+
+    if (options?.onChunk) {
+      this.streamHandlers.set(id, options.onChunk);
+    }
+
     return new Promise((resolve, reject) => {
       const timeoutMs = options?.timeout || this.timeout;
-      
+
       const timeout = setTimeout(() => {
         this.pendingRequests.delete(id);
+        this.streamHandlers.delete(id);
         reject(new Error(`Request timeout after ${timeoutMs}ms`));
       }, timeoutMs);
-      
-      this.pendingRequests.set(id, { resolve, reject, timeout });
-      
-      // Send request
-      const requestLine = JSON.stringify(request) + '\n';
-      this.process!.stdin!.write(requestLine, (error) => {
+
+      this.pendingRequests.set(id, {
+        resolve: (value: any) => {
+          this.streamHandlers.delete(id);
+          resolve(value);
+        },
+        reject: (error: Error) => {
+          this.streamHandlers.delete(id);
+          reject(error);
+        },
+        timeout,
+      });
+
+      // Send request: control traffic goes down its own pipe so it is
+      // never stuck behind a multi-MB data frame
+      const viaControl = this.controlIn !== null && CONTROL_METHODS.has(method);
+      const stream = viaControl ? this.controlIn! : this.process!.stdin!;
+      const payload = viaControl
+        ? JSON.stringify(request) + '\n'
+        : this.encodeRequest(request);
+
+      stream.write(payload, (error) => {
         if (error) {
           clearTimeout(timeout);
           this.pendingRequests.delete(id);
+          this.streamHandlers.delete(id);
           reject(error);
         }
       });
@@ -248,16 +806,38 @@ export class LightRAGBridge extends EventEmitter {
   
   async restart(): Promise<void> {
     this.emit('restarting', this.restartCount + 1);
-    
+
+    // Let in-flight and queued writes settle before killing the process:
+    // reads are cheap to retry, but a write batch cut off mid-flight loses
+    // work that the checkpoint would otherwise have made durable
+    await this.drainWrites();
+
     await this.stop();
     await new Promise((resolve) => setTimeout(resolve, 1000));
     await this.start();
   }
+
+  /**
+   * Wait (bounded) for in-flight and queued bulk write requests to finish.
+   * Returns early if the process dies while draining.
+   */
+  private async drainWrites(timeoutMs = this.drainTimeoutMs): Promise<void> {
+    const deadline = Date.now() + timeoutMs;
+    while (
+      (this.inFlight.bulk > 0 || this.queues.bulk.length > 0) &&
+      Date.now() < deadline &&
+      this.process &&
+      !this.process.killed
+    ) {
+      await new Promise((resolve) => setTimeout(resolve, 100));
+    }
+  }
   
   async stop(): Promise<void> {
     this.isShuttingDown = true;
     this.stopHealthCheck();
-    
+    this.stopParseWorker();
+
     if (this.process) {
       // Reject all pending requests
       for (const [id, pending] of this.pendingRequests.entries()) {
@@ -265,6 +845,7 @@ export class LightRAGBridge extends EventEmitter {
         pending.reject(new Error('Bridge stopped'));
       }
       this.pendingRequests.clear();
+      this.rejectQueued(new Error('Bridge stopped'));
       
       // Kill process
       this.process.kill('SIGTERM');
@@ -287,8 +868,9 @@ export class LightRAGBridge extends EventEmitter {
       });
       
       this.process = null;
+      this.controlIn = null;
     }
-    
+
     this.isShuttingDown = false;
     this.emit('stopped');
   }
@@ -296,4 +878,25 @@ export class LightRAGBridge extends EventEmitter {
   isRunning(): boolean {
     return this.process !== null && !this.process.killed;
   }
+
+  private rejectQueued(error: Error): void {
+    for (const priorityClass of PRIORITY_ORDER) {
+      for (const queued of this.queues[priorityClass]) {
+        queued.reject(error);
+      }
+      this.queues[priorityClass] = [];
+    }
+  }
+
+  get pendingCount(): number {
+    return this.pendingRequests.size;
+  }
+
+  get queueDepths(): Record<PriorityClass, number> {
+    return {
+      control: this.queues.control.length,
+      interactive: this.queues.interactive.length,
+      bulk: this.queues.bulk.length,
+    };
+  }
 }
@@ -8,6 +8,12 @@ export interface LightRAGConfig {
   neo4jUri?: string;
   neo4jUsername?: string;
   neo4jPassword?: string;
+  poolSize?: number;
+  workspaces?: Record<string, string>;
+  maxWarmWorkspaces?: number;
+  indexBundle?: string;
+  backendPoolSize?: number;
+  backendWarmup?: boolean;
 }
 
 export interface JSONRPCRequest {
@@ -32,10 +38,29 @@ export interface JSONRPCError {
 
 export interface IndexFilesParams {
   file_paths: string[];
+  background?: boolean;
+}
+
+export interface IndexJobStatus {
+  job_id: string;
+  status: 'running' | 'completed' | 'failed' | 'cancelled' | 'interrupted';
+  total: number;
+  processed: number;
+  success_count: number;
+  skipped_count: number;
+  error_count: number;
+  errors: string[];
+  started_at: number;
+  finished_at: number | null;
+  elapsed_seconds: number;
+  eta_seconds?: number;
 }
 
 export interface IndexFilesResult {
   success_count: number;
+  skipped_count: number;
+  new_count: number;
+  updated_count: number;
   error_count: number;
   errors: string[];
   total: number;
@@ -54,11 +79,42 @@ export interface SearchCodeParams {
   ll_keywords?: string[];
 }
 
+export interface ContextChunk {
+  id: string;
+  content: string;
+  file_path: string;
+  score?: number;
+}
+
+export interface ContextEntity {
+  name: string;
+  entity_type: string;
+  description: string;
+  source_id: string;
+}
+
+export interface ContextRelation {
+  source: string;
+  target: string;
+  description: string;
+  keywords: string;
+  weight: number;
+}
+
+export interface SearchContext {
+  chunks: ContextChunk[];
+  entities: ContextEntity[];
+  relations: ContextRelation[];
+}
+
 export interface SearchCodeResult {
   answer: string;
+  context?: SearchContext;
   query: string;
   mode: string;
   top_k: number;
+  cached?: boolean;
+  streamed?: boolean;
 }
 
 export interface GetEntityParams {
@@ -67,8 +123,11 @@ export interface GetEntityParams {
 
 export interface GetEntityResult {
   entity_name: string;
+  found: boolean;
+  entity_type?: string;
   description: string;
-  search_mode: string;
+  source_id?: string;
+  degree?: number;
 }
 
 export interface GetRelationshipsParams {
@@ -77,11 +136,21 @@ export interface GetRelationshipsParams {
   depth?: number;
 }
 
+export interface EntityRelationship {
+  source: string;
+  target: string;
+  description: string;
+  keywords: string;
+  weight: number;
+  depth: number;
+}
+
 export interface GetRelationshipsResult {
   entity_name: string;
+  found: boolean;
   relation_type: string;
   depth: number;
-  relationships: string;
+  relationships: EntityRelationship[];
 }
 
 export interface VisualizeSubgraphParams {
@@ -95,6 +164,8 @@ export interface VisualizeSubgraphResult {
   format: string;
   diagram: string;
   max_nodes: number;
+  node_count: number;
+  edge_count: number;
 }
 
 export interface InsertTextParams {
@@ -107,12 +178,51 @@ export interface InsertTextResult {
   message: string;
 }
 
+export interface InsertTextsParams {
+  items: Array<{ text: string; metadata?: Record<string, any> }>;
+}
+
+export interface InsertTextsResult {
+  success_count: number;
+  error_count: number;
+  results: InsertTextResult[];
+  total: number;
+}
+
 export interface IndexingStatusResult {
   initialized: boolean;
   working_dir: string;
   working_dir_size_bytes: number;
+  index_stats: {
+    documents: number;
+    inserted_docs: number;
+    chunks: number;
+    content_bytes: number;
+    entities: number;
+    relations: number;
+  };
   storage_backends: {
     milvus: string;
     neo4j: string;
   };
+  backend_pools?: Record<string, {
+    connected: boolean;
+    pool_size: number;
+    warmup_ms: number | null;
+    reconnects: number;
+    consecutive_failures: number;
+    last_error: string | null;
+    in_flight_requests: number;
+  }>;
+  query_cache: {
+    generation: number;
+    entries: number;
+    hits: number;
+    misses: number;
+  };
+  embedding_cache: {
+    entries: number;
+    hits: number;
+    misses: number;
+  };
 }
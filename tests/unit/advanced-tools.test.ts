@@ -22,6 +22,14 @@ function createMockReadable(): Readable {
   return readable;
 }
 
+// Push a message to the mock process using the bridge's length-prefixed framing
+function pushMessage(mockProcess: any, message: any): void {
+  const payload = Buffer.from(JSON.stringify(message), 'utf-8');
+  const header = Buffer.alloc(4);
+  header.writeUInt32BE(payload.length, 0);
+  mockProcess.stdout.push(Buffer.concat([header, payload]));
+}
+
 describe('Advanced Tools (Mocked)', () => {
   let bridge: any;
   let mockProcess: any;
@@ -48,7 +56,14 @@ describe('Advanced Tools (Mocked)', () => {
     mockProcess.kill = jest.fn();
     mockProcess.killed = false;
 
-    mockSpawn.mockReturnValue(mockProcess);
+    // Emit the readiness handshake as soon as the bridge spawns, like the
+    // real wrapper does after eager initialization
+    mockSpawn.mockImplementation(() => {
+      setImmediate(() => {
+        pushMessage(mockProcess, { jsonrpc: '2.0', method: 'ready', params: { ok: true } });
+      });
+      return mockProcess;
+    });
 
     bridge = new LightRAGBridge(testConfig);
     await bridge.start();
@@ -69,7 +84,7 @@ describe('Advanced Tools (Mocked)', () => {
 
       // Simulate response from Python process
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -78,7 +93,6 @@ describe('Advanced Tools (Mocked)', () => {
             search_mode: 'local',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -93,7 +107,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -102,7 +116,6 @@ describe('Advanced Tools (Mocked)', () => {
             search_mode: 'local',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -118,7 +131,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -128,7 +141,6 @@ describe('Advanced Tools (Mocked)', () => {
             relationships: 'keymanager_keystore_enable_iterator calls execute() method',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -144,7 +156,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -154,7 +166,6 @@ describe('Advanced Tools (Mocked)', () => {
             relationships: 'Calls execute(), init(), and finalize()',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -169,7 +180,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -179,7 +190,6 @@ describe('Advanced Tools (Mocked)', () => {
             relationships: 'Multi-level relationships up to depth 2',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -196,7 +206,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -206,7 +216,6 @@ describe('Advanced Tools (Mocked)', () => {
             diagram: 'graph TD\n    A[keymanager_keystore_enable_iterator] --> B[execute]\n    A --> C[init]',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -225,7 +234,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: {
@@ -235,7 +244,6 @@ describe('Advanced Tools (Mocked)', () => {
             diagram: 'graph TD\n    A[Class1] --> B[Class2]',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       const result = await responsePromise;
@@ -250,7 +258,7 @@ describe('Advanced Tools (Mocked)', () => {
       });
 
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           error: {
@@ -258,7 +266,6 @@ describe('Advanced Tools (Mocked)', () => {
             message: 'Unsupported format \'graphviz\'. Only \'mermaid\' format is supported.',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
 
       await expect(responsePromise).rejects.toThrow(/unsupported format/i);
@@ -0,0 +1,147 @@
+import { jest } from '@jest/globals';
+import { EventEmitter } from 'events';
+import { Readable } from 'stream';
+
+// Mock child_process BEFORE importing the pool using unstable_mockModule for ESM
+const mockSpawn = jest.fn();
+await jest.unstable_mockModule('child_process', () => ({
+  spawn: mockSpawn,
+  ChildProcess: EventEmitter,
+}));
+
+// Now dynamically import after setting up mocks
+const { LightRAGBridgePool } = await import('../../src/bridge-pool.js');
+
+// Helper to create a mock readable stream
+function createMockReadable(): Readable {
+  const readable = new Readable({
+    read() {
+      // No-op
+    },
+  });
+  return readable;
+}
+
+// Push a message to a mock process using the bridge's length-prefixed framing
+function pushMessage(mockProcess: any, message: any): void {
+  const payload = Buffer.from(JSON.stringify(message), 'utf-8');
+  const header = Buffer.alloc(4);
+  header.writeUInt32BE(payload.length, 0);
+  mockProcess.stdout.push(Buffer.concat([header, payload]));
+}
+
+// Decode everything the bridge wrote to a mock process stdin
+function writtenData(mockProcess: any): string {
+  return mockProcess.stdin.write.mock.calls
+    .map((call: any) => (Buffer.isBuffer(call[0]) ? call[0].toString('utf-8') : String(call[0])))
+    .join('');
+}
+
+function createMockProcess(): any {
+  const mockProcess: any = new EventEmitter();
+  mockProcess.stdin = {
+    write: jest.fn((data: any, callback?: () => void) => {
+      if (callback) callback();
+    }) as any,
+  };
+  mockProcess.stdout = createMockReadable();
+  mockProcess.stderr = createMockReadable();
+  mockProcess.kill = jest.fn();
+  mockProcess.killed = false;
+  return mockProcess;
+}
+
+describe('LightRAGBridgePool', () => {
+  let pool: any;
+  let mockProcesses: any[];
+
+  const testConfig = {
+    workingDir: '/tmp/test',
+    openaiApiKey: 'test-key',
+    openaiBaseUrl: 'https://test.com',
+    autoRestart: false, // Disable for tests
+    poolSize: 2,
+  };
+
+  beforeEach(() => {
+    mockProcesses = [];
+    mockSpawn.mockImplementation(() => {
+      const mockProcess = createMockProcess();
+      mockProcesses.push(mockProcess);
+      // Emit the readiness handshake like the real wrapper does
+      setImmediate(() => {
+        pushMessage(mockProcess, { jsonrpc: '2.0', method: 'ready', params: { ok: true } });
+      });
+      return mockProcess;
+    });
+
+    pool = new LightRAGBridgePool(testConfig);
+  });
+
+  afterEach(async () => {
+    if (pool && pool.isRunning()) {
+      await pool.stop();
+    }
+    jest.clearAllMocks();
+  });
+
+  describe('start', () => {
+    it('should spawn one process per worker', async () => {
+      await pool.start();
+
+      expect(mockSpawn).toHaveBeenCalledTimes(2);
+      expect(pool.isRunning()).toBe(true);
+      expect(pool.size).toBe(2);
+    });
+  });
+
+  describe('routing', () => {
+    beforeEach(async () => {
+      await pool.start();
+    });
+
+    it('should serialize write methods through worker 0', async () => {
+      const callPromise = pool.call('index_files', { file_paths: ['/a.cpp'] });
+
+      setTimeout(() => {
+        pushMessage(mockProcesses[0], {
+          jsonrpc: '2.0',
+          id: 1,
+          result: { success_count: 1 },
+        });
+      }, 10);
+
+      await callPromise;
+
+      expect(writtenData(mockProcesses[0])).toContain('"method":"index_files"');
+      expect(mockProcesses[1].stdin.write).not.toHaveBeenCalled();
+    });
+
+    it('should route reads to the least-loaded worker', async () => {
+      // Occupy worker 0 with an unresolved write
+      const writePromise = pool.call('index_files', { file_paths: ['/a.cpp'] });
+
+      const readPromise = pool.call('search_code', { query: 'test' });
+
+      setTimeout(() => {
+        pushMessage(mockProcesses[1], { jsonrpc: '2.0', id: 1, result: { answer: 'ok' } });
+        pushMessage(mockProcesses[0], { jsonrpc: '2.0', id: 1, result: { success_count: 1 } });
+      }, 10);
+
+      await Promise.all([writePromise, readPromise]);
+
+      expect(writtenData(mockProcesses[1])).toContain('"method":"search_code"');
+    });
+  });
+
+  describe('stop', () => {
+    it('should stop all workers', async () => {
+      await pool.start();
+      await pool.stop();
+
+      expect(mockProcesses[0].kill).toHaveBeenCalledWith('SIGTERM');
+      expect(mockProcesses[1].kill).toHaveBeenCalledWith('SIGTERM');
+      expect(pool.isRunning()).toBe(false);
+    });
+  });
+});
@@ -22,6 +22,21 @@ function createMockReadable(): Readable {
   return readable;
 }
 
+// Push a message to the mock process using the bridge's length-prefixed framing
+function pushMessage(mockProcess: any, message: any): void {
+  const payload = Buffer.from(JSON.stringify(message), 'utf-8');
+  const header = Buffer.alloc(4);
+  header.writeUInt32BE(payload.length, 0);
+  mockProcess.stdout.push(Buffer.concat([header, payload]));
+}
+
+// Decode everything the bridge wrote to the mock process stdin
+function writtenData(mockProcess: any): string {
+  return mockProcess.stdin.write.mock.calls
+    .map((call: any) => (Buffer.isBuffer(call[0]) ? call[0].toString('utf-8') : String(call[0])))
+    .join('');
+}
+
 describe('LightRAGBridge', () => {
   let bridge: any;
   let mockProcess: any;
@@ -47,8 +62,15 @@ describe('LightRAGBridge', () => {
     mockProcess.kill = jest.fn();
     mockProcess.killed = false;
     
-    mockSpawn.mockReturnValue(mockProcess);
-    
+    // Emit the readiness handshake as soon as the bridge spawns, like the
+    // real wrapper does after eager initialization
+    mockSpawn.mockImplementation(() => {
+      setImmediate(() => {
+        pushMessage(mockProcess, { jsonrpc: '2.0', method: 'ready', params: { ok: true } });
+      });
+      return mockProcess;
+    });
+
     bridge = new LightRAGBridge(testConfig);
   });
   
@@ -67,7 +89,8 @@ describe('LightRAGBridge', () => {
         expect.any(String),
         expect.arrayContaining([expect.stringContaining('lightrag_wrapper.py')]),
         expect.objectContaining({
-          stdio: ['pipe', 'pipe', 'pipe'],
+          // stdio 0-2 plus the fd 3/4 control channel, which defaults on
+          stdio: ['pipe', 'pipe', 'pipe', 'pipe', 'pipe'],
         })
       );
       
@@ -91,28 +114,24 @@ describe('LightRAGBridge', () => {
       
       // Simulate response from Python process
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           result: 'pong',
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
-      
+
       const result = await responsePromise;
       expect(result).toBe('pong');
-      
-      expect(mockProcess.stdin.write).toHaveBeenCalledWith(
-        expect.stringContaining('"method":"ping"'),
-        expect.any(Function)
-      );
+
+      expect(writtenData(mockProcess)).toContain('"method":"ping"');
     });
     
     it('should handle JSON-RPC error response', async () => {
       const responsePromise = bridge.call('unknown_method', {});
       
       setTimeout(() => {
-        const response = JSON.stringify({
+        pushMessage(mockProcess, {
           jsonrpc: '2.0',
           id: 1,
           error: {
@@ -120,7 +139,6 @@ describe('LightRAGBridge', () => {
             message: 'Method not found',
           },
         });
-        mockProcess.stdout.push(response + '\n');
       }, 10);
       
       await expect(responsePromise).rejects.toThrow('Method not found');
@@ -183,6 +201,130 @@ describe('LightRAGBridge', () => {
     });
   });
   
+  describe('priority scheduling', () => {
+    beforeEach(async () => {
+      bridge = new LightRAGBridge({
+        ...testConfig,
+        maxInFlight: { bulk: 1 },
+        maxQueueDepth: 1,
+      });
+      await bridge.start();
+    });
+
+    it('should fast-fail bulk requests beyond the queue depth', async () => {
+      // First bulk call takes the only slot, second fills the queue
+      const first = bridge.call('index_files', { file_paths: ['/a.cpp'] });
+      const second = bridge.call('index_files', { file_paths: ['/b.cpp'] });
+
+      await expect(
+        bridge.call('index_files', { file_paths: ['/c.cpp'] })
+      ).rejects.toThrow('queue full');
+
+      // Interactive traffic is unaffected by bulk saturation
+      const searchPromise = bridge.call('search_code', { query: 'test' });
+
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: { success_count: 1 } });
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 2, result: { answer: 'ok' } });
+
+      await first;
+      await searchPromise;
+
+      // Completion of the first bulk call dispatches the queued one
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 3, result: { success_count: 1 } });
+      await second;
+    });
+  });
+
+  describe('search coalescing', () => {
+    beforeEach(async () => {
+      await bridge.start();
+    });
+
+    it('should share one wrapper call across identical in-flight searches', async () => {
+      const first = bridge.call('search_code', { query: 'arch', mode: 'hybrid' });
+      const second = bridge.call('search_code', { mode: 'hybrid', query: 'arch' });
+
+      // Only one request went over the wire
+      expect((writtenData(mockProcess).match(/"method":"search_code"/g) || []).length).toBe(1);
+
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: { answer: 'shared' } });
+
+      const [a, b] = await Promise.all([first, second]);
+      expect(a).toEqual({ answer: 'shared' });
+      expect(b).toEqual({ answer: 'shared' });
+    });
+
+    it('should not coalesce searches with different parameters', async () => {
+      const first = bridge.call('search_code', { query: 'arch', mode: 'hybrid' });
+      const second = bridge.call('search_code', { query: 'arch', mode: 'local' });
+
+      expect((writtenData(mockProcess).match(/"method":"search_code"/g) || []).length).toBe(2);
+
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: { answer: 'one' } });
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 2, result: { answer: 'two' } });
+
+      await expect(first).resolves.toEqual({ answer: 'one' });
+      await expect(second).resolves.toEqual({ answer: 'two' });
+    });
+
+    it('should issue a fresh request once the first search settles', async () => {
+      const first = bridge.call('search_code', { query: 'arch' });
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: { answer: 'one' } });
+      await first;
+
+      const second = bridge.call('search_code', { query: 'arch' });
+      expect((writtenData(mockProcess).match(/"method":"search_code"/g) || []).length).toBe(2);
+
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 2, result: { answer: 'fresh' } });
+      await expect(second).resolves.toEqual({ answer: 'fresh' });
+    });
+  });
+
+  describe('large response offloading', () => {
+    it('should parse over-threshold responses on the worker thread', async () => {
+      bridge = new LightRAGBridge({ ...testConfig, parseOffloadThreshold: 1024 });
+      await bridge.start();
+
+      const responsePromise = bridge.call('search_code', { query: 'big', only_context: true });
+
+      const bigContext = 'x'.repeat(4096);
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: { context: bigContext } });
+
+      const result = await responsePromise;
+      expect(result.context).toBe(bigContext);
+      expect(bridge.getMetrics().offloaded_parses).toBe(1);
+    });
+
+    it('should keep small responses on the inline fast path', async () => {
+      bridge = new LightRAGBridge({ ...testConfig, parseOffloadThreshold: 1024 });
+      await bridge.start();
+
+      const responsePromise = bridge.call('ping', {});
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: 'pong' });
+
+      await expect(responsePromise).resolves.toBe('pong');
+      expect(bridge.getMetrics().offloaded_parses).toBe(0);
+    });
+
+    it('should deliver responses in order across the fast and slow paths', async () => {
+      bridge = new LightRAGBridge({ ...testConfig, parseOffloadThreshold: 1024 });
+      await bridge.start();
+
+      const big = bridge.call('search_code', { query: 'big' });
+      const small = bridge.call('ping', {});
+
+      const settled: string[] = [];
+      big.then(() => settled.push('big'));
+      small.then(() => settled.push('small'));
+
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 1, result: { context: 'y'.repeat(4096) } });
+      pushMessage(mockProcess, { jsonrpc: '2.0', id: 2, result: 'pong' });
+
+      await Promise.all([big, small]);
+      expect(settled).toEqual(['big', 'small']);
+    });
+  });
+
   describe('isRunning', () => {
     it('should return false when not started', () => {
       expect(bridge.isRunning()).toBe(false);
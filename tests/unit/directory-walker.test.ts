@@ -0,0 +1,95 @@
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { walkDirectoryBatches, globToRegExp } from '../../src/directory-walker.js';
+
+async function collect(root: string, options = {}): Promise<string[]> {
+  const files: string[] = [];
+  for await (const batch of walkDirectoryBatches(root, options)) {
+    files.push(...batch);
+  }
+  return files.sort();
+}
+
+describe('directory-walker', () => {
+  let root: string;
+
+  beforeEach(() => {
+    root = fs.mkdtempSync(path.join(os.tmpdir(), 'walker-test-'));
+
+    fs.mkdirSync(path.join(root, 'src'));
+    fs.mkdirSync(path.join(root, 'build'));
+    fs.mkdirSync(path.join(root, 'docs'));
+
+    fs.writeFileSync(path.join(root, 'src', 'main.cpp'), 'int main() {}');
+    fs.writeFileSync(path.join(root, 'src', 'util.h'), '#pragma once');
+    fs.writeFileSync(path.join(root, 'src', 'notes.txt'), 'notes');
+    fs.writeFileSync(path.join(root, 'build', 'out.o'), 'obj');
+    fs.writeFileSync(path.join(root, 'docs', 'readme.md'), '# docs');
+    fs.writeFileSync(path.join(root, 'generated.cpp'), '// generated');
+  });
+
+  afterEach(() => {
+    fs.rmSync(root, { recursive: true, force: true });
+  });
+
+  describe('globToRegExp', () => {
+    it('should match recursive and single-level patterns', () => {
+      expect(globToRegExp('**/*.cpp', false).test('src/deep/main.cpp')).toBe(true);
+      expect(globToRegExp('*.cpp', true).test('src/main.cpp')).toBe(true);
+      expect(globToRegExp('src/*.cpp', false).test('src/deep/main.cpp')).toBe(false);
+    });
+  });
+
+  describe('walkDirectoryBatches', () => {
+    it('should walk all files, skipping default-excluded directories', async () => {
+      fs.mkdirSync(path.join(root, 'node_modules'));
+      fs.writeFileSync(path.join(root, 'node_modules', 'dep.js'), 'x');
+
+      const files = await collect(root);
+
+      expect(files).toContain(path.join(root, 'src', 'main.cpp'));
+      expect(files).toContain(path.join(root, 'docs', 'readme.md'));
+      expect(files.some((f) => f.includes('node_modules'))).toBe(false);
+    });
+
+    it('should apply include and exclude globs', async () => {
+      const files = await collect(root, {
+        include: ['**/*.cpp', '**/*.h'],
+        exclude: ['generated.cpp'],
+      });
+
+      expect(files).toEqual([
+        path.join(root, 'src', 'main.cpp'),
+        path.join(root, 'src', 'util.h'),
+      ]);
+    });
+
+    it('should honor .gitignore files', async () => {
+      fs.writeFileSync(path.join(root, '.gitignore'), 'build/\n*.txt\n');
+
+      const files = await collect(root);
+
+      expect(files.some((f) => f.includes('out.o'))).toBe(false);
+      expect(files.some((f) => f.endsWith('notes.txt'))).toBe(false);
+      expect(files).toContain(path.join(root, 'src', 'main.cpp'));
+    });
+
+    it('should yield batches of the requested size', async () => {
+      const batches: string[][] = [];
+      for await (const batch of walkDirectoryBatches(root, { batchSize: 2 })) {
+        batches.push(batch);
+      }
+
+      expect(batches.length).toBeGreaterThan(1);
+      for (const batch of batches.slice(0, -1)) {
+        expect(batch.length).toBe(2);
+      }
+    });
+
+    it('should respect max_files', async () => {
+      const files = await collect(root, { maxFiles: 3 });
+      expect(files.length).toBeLessThanOrEqual(3);
+    });
+  });
+});
@@ -0,0 +1,88 @@
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { DirectoryWatcher } from '../../src/file-watcher.js';
+
+function waitForBatch(watcher: DirectoryWatcher, timeoutMs = 2000): Promise<string[]> {
+  return new Promise((resolve, reject) => {
+    const timer = setTimeout(
+      () => reject(new Error('No batch emitted within timeout')),
+      timeoutMs
+    );
+    watcher.once('batch', (files: string[]) => {
+      clearTimeout(timer);
+      resolve(files);
+    });
+  });
+}
+
+describe('DirectoryWatcher', () => {
+  let root: string;
+  let watcher: DirectoryWatcher;
+
+  beforeEach(() => {
+    root = fs.mkdtempSync(path.join(os.tmpdir(), 'watcher-test-'));
+    fs.mkdirSync(path.join(root, 'src'));
+    fs.writeFileSync(path.join(root, 'src', 'main.cpp'), 'int main() {}');
+  });
+
+  afterEach(() => {
+    if (watcher) {
+      watcher.close();
+    }
+    fs.rmSync(root, { recursive: true, force: true });
+  });
+
+  it('should emit a debounced batch when a watched file changes', async () => {
+    watcher = new DirectoryWatcher(root, { debounceMs: 50 });
+    await watcher.start();
+
+    const batchPromise = waitForBatch(watcher);
+    fs.writeFileSync(path.join(root, 'src', 'main.cpp'), 'int main() { return 1; }');
+
+    const batch = await batchPromise;
+    expect(batch).toContain(path.join(root, 'src', 'main.cpp'));
+  });
+
+  it('should collapse rapid edits into one batch', async () => {
+    watcher = new DirectoryWatcher(root, { debounceMs: 100 });
+    await watcher.start();
+
+    const batchPromise = waitForBatch(watcher);
+    fs.writeFileSync(path.join(root, 'src', 'main.cpp'), 'v1');
+    fs.writeFileSync(path.join(root, 'src', 'util.h'), 'v1');
+    fs.writeFileSync(path.join(root, 'src', 'main.cpp'), 'v2');
+
+    const batch = await batchPromise;
+    expect(batch.sort()).toEqual([
+      path.join(root, 'src', 'main.cpp'),
+      path.join(root, 'src', 'util.h'),
+    ].sort());
+  });
+
+  it('should honor include patterns', async () => {
+    watcher = new DirectoryWatcher(root, { include: ['**/*.cpp'], debounceMs: 50 });
+    await watcher.start();
+
+    const batchPromise = waitForBatch(watcher);
+    fs.writeFileSync(path.join(root, 'src', 'notes.txt'), 'ignored');
+    fs.writeFileSync(path.join(root, 'src', 'feature.cpp'), 'void f() {}');
+
+    const batch = await batchPromise;
+    expect(batch).toEqual([path.join(root, 'src', 'feature.cpp')]);
+  });
+
+  it('should stop emitting after close', async () => {
+    watcher = new DirectoryWatcher(root, { debounceMs: 50 });
+    await watcher.start();
+    watcher.close();
+
+    const onBatch = jest.fn();
+    watcher.on('batch', onBatch);
+    fs.writeFileSync(path.join(root, 'src', 'main.cpp'), 'changed');
+
+    await new Promise((resolve) => setTimeout(resolve, 200));
+    expect(onBatch).not.toHaveBeenCalled();
+    expect(watcher.watchedDirectoryCount).toBe(0);
+  });
+});